@@ -429,6 +429,20 @@ autoEEG EEG_readFromBdfFile (MelderFile file) {
 	}
 }
 
+/*
+	Process all electrode channels (not the extra sensors) in place, in parallel.
+	Each thread handles at least some 100,000 samples, so that short recordings stay single-threaded.
+*/
+template <typename ChannelProcessor>
+static void EEG_processElectrodeChannels (EEG me, ChannelProcessor process) {
+	const integer numberOfElectrodeChannels = my numberOfChannels - EEG_getNumberOfExtraSensors (me);
+	const integer thresholdNumberOfChannelsPerThread = std::max (1_integer, 100'000 / std::max (1_integer, my sound -> nx));
+	MelderThread_PARALLEL (numberOfElectrodeChannels, thresholdNumberOfChannelsPerThread) {
+		MelderThread_FOR (ichan)
+			process (my sound -> z.row (ichan));
+	} MelderThread_ENDPARALLEL
+}
+
 static void detrend (VEC const& channel) {
 	const double firstValue = channel [1], lastValue = channel [channel.size];
 	channel [1] = channel [channel.size] = 0.0;
@@ -437,28 +451,23 @@ static void detrend (VEC const& channel) {
 }
 
 void EEG_detrend (EEG me) {
-	for (integer ichan = 1; ichan <= my numberOfChannels - EEG_getNumberOfExtraSensors (me); ichan ++)
-		detrend (my sound -> z.row (ichan));
+	EEG_processElectrodeChannels (me, [] (VEC const& channel) {
+		detrend (channel);
+	});
 }
 
 void EEG_filter (EEG me, double lowFrequency, double lowWidth, double highFrequency, double highWidth, bool doNotch50Hz) {
 	try {
-/*
-	integer nsampFFT = 1;
-	while (nsampFFT < my sound -> nx)
-		nsampFFT *= 2;
-	autoNUMFourierTable fftTable = NUMFourierTable_create (nsampFFT);
-*/
-		for (integer ichan = 1; ichan <= my numberOfChannels - EEG_getNumberOfExtraSensors (me); ichan ++) {
-			autoSound channel = Sound_extractChannel (my sound.get(), ichan);
-			autoSpectrum spec = Sound_to_Spectrum (channel.get(), true);
-			Spectrum_passHannBand (spec.get(), lowFrequency, 0.0, lowWidth);
-			Spectrum_passHannBand (spec.get(), 0.0, highFrequency, highWidth);
-			if (doNotch50Hz)
-				Spectrum_stopHannBand (spec.get(), 48.0, 52.0, 1.0);
-			autoSound him = Spectrum_to_Sound (spec.get());
-			my sound -> z.row (ichan)  <<=  his z.row (1).part (1, my sound -> nx);
-		}
+		/*
+			The three filters together form a single gain curve, which is the same for all channels.
+		*/
+		autoSpectrum gain = Sound_to_Spectrum_unity (my sound.get());
+		Spectrum_passHannBand (gain.get(), lowFrequency, 0.0, lowWidth);
+		Spectrum_passHannBand (gain.get(), 0.0, highFrequency, highWidth);
+		if (doNotch50Hz)
+			Spectrum_stopHannBand (gain.get(), 48.0, 52.0, 1.0);
+		const integer numberOfElectrodeChannels = my numberOfChannels - EEG_getNumberOfExtraSensors (me);
+		Sound_filterWithGain_inplace (my sound.get(), 1, numberOfElectrodeChannels, gain -> z.row (1));
 	} catch (MelderError) {
 		Melder_throw (me, U": not filtered.");
 	}
@@ -492,12 +501,17 @@ void EEG_subtractReference (EEG me, conststring32 channelName1, conststring32 ch
 	integer channelNumber2 = EEG_getChannelNumber (me, channelName2);
 	if (channelNumber2 == 0 && channelName2 [0] != U'\0')
 		Melder_throw (me, U": no channel named “", channelName2, U"”.");
-	const integer numberOfElectrodeChannels = my numberOfChannels - EEG_getNumberOfExtraSensors (me);
-	for (integer isamp = 1; isamp <= my sound -> nx; isamp ++) {
-		const double referenceValue = ( channelNumber2 == 0 ? my sound -> z [channelNumber1] [isamp] :
-				0.5 * (my sound -> z [channelNumber1] [isamp] + my sound -> z [channelNumber2] [isamp]) );
-		my sound -> z.column (isamp).part (1, numberOfElectrodeChannels)  -=  referenceValue;
+	/*
+		Copy the reference first, because the reference channels themselves will change.
+	*/
+	autoVEC reference = copy_VEC (my sound -> z.row (channelNumber1));
+	if (channelNumber2 != 0) {
+		reference.get()  +=  my sound -> z.row (channelNumber2);
+		reference.get()  *=  0.5;
 	}
+	EEG_processElectrodeChannels (me, [&] (VEC const& channel) {
+		channel  -=  reference.get();
+	});
 }
 
 void EEG_subtractMeanChannel (EEG me, integer fromChannel, integer toChannel) {
@@ -507,11 +521,13 @@ void EEG_subtractMeanChannel (EEG me, integer fromChannel, integer toChannel) {
 		Melder_throw (U"No channel ", toChannel, U".");
 	if (fromChannel > toChannel)
 		Melder_throw (U"Channel range cannot run from ", fromChannel, U" to ", toChannel, U". Please reverse.");
-	const integer numberOfElectrodeChannels = my numberOfChannels - EEG_getNumberOfExtraSensors (me);
-	for (integer isamp = 1; isamp <= my sound -> nx; isamp ++) {
-		const double referenceValue = NUMmean (my sound -> z.column (isamp).part (fromChannel, toChannel));
-		my sound -> z.column (isamp).part (1, numberOfElectrodeChannels)  -=  referenceValue;
-	}
+	autoVEC reference = zero_VEC (my sound -> nx);
+	for (integer ichan = fromChannel; ichan <= toChannel; ichan ++)
+		reference.get()  +=  my sound -> z.row (ichan);
+	reference.get()  *=  1.0 / (toChannel - fromChannel + 1);
+	EEG_processElectrodeChannels (me, [&] (VEC const& channel) {
+		channel  -=  reference.get();
+	});
 }
 
 void EEG_setChannelToZero (EEG me, integer channelNumber) {
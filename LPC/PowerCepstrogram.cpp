@@ -1,6 +1,6 @@
 /* PowerCepstrogram.cpp
  *
- * Copyright (C) 2013-2025 David Weenink
+ * Copyright (C) 2013-2025 David Weenink, 2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -357,7 +357,7 @@ static autoPowerCepstrogram PowerCepstrogram_smoothGaussian (PowerCepstrogram me
 		if (numberOfFrames > 1.0) {
 			const double sigma = numberOfFrames / numberOfSigmasInWindow;  // 2sigma -> 95.4%, 3sigma -> 99.7 % of the data
 			const integer nfft = Melder_clippedLeft (2_integer, Melder_iroundUpToPowerOfTwo (my nx));   // TODO: explain edge case
-			autoNUMFourierTable fourierTable = NUMFourierTable_create (nfft);
+			sharedNUMFourierTable fourierTable = NUMFourierTable_getShared (nfft);
 			for (integer iq = 1; iq <= my ny; iq ++) {
 				VECsmooth_gaussian (thy z.row (iq), my z.row (iq), sigma, fourierTable.get());
 				abs_VEC_inout (thy z.row (iq));
@@ -369,7 +369,7 @@ static autoPowerCepstrogram PowerCepstrogram_smoothGaussian (PowerCepstrogram me
 		const double numberOfQuefrencyBins = quefrencyAveragingWindow / my dy;
 		if (numberOfQuefrencyBins > 1.0) {
 			const integer nfft = Melder_clippedLeft (2_integer, Melder_iroundUpToPowerOfTwo (my ny));   // TODO: explain edge case
-			autoNUMFourierTable fourierTable = NUMFourierTable_create (nfft);
+			sharedNUMFourierTable fourierTable = NUMFourierTable_getShared (nfft);
 			const double sigma = numberOfQuefrencyBins / numberOfSigmasInWindow;  // 2sigma -> 95.4%, 3sigma -> 99.7 % of the data
 			for (integer iframe = 1; iframe <= my nx; iframe ++) {
 				VECsmooth_gaussian_inplace (thy z.column (iframe), sigma, fourierTable.get());
@@ -1,6 +1,6 @@
 /* Sound_to_PowerCepstrogram.cpp
  *
- * Copyright (C) 2012-2025 David Weenink, 2025 Paul Boersma
+ * Copyright (C) 2012-2025 David Weenink, 2025,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -48,13 +48,28 @@ autoPowerCepstrogram Sound_to_PowerCepstrogram (constSound me, double pitchFloor
 		autoPowerCepstrogram output = PowerCepstrogram_create (my xmin, my xmax, nFrames, dt, t1, 0, qmax, numberOfFrequencies, dq, 0);
 		bool subtractFrameMean = true;
 		const double powerScaling = input -> dx * input -> dx; // =amplitude_scaling^2
-
-		MelderThread_PARALLEL (nFrames, 10) {
-			autoSoundFrames soundFrames = SoundFrames_createForIntoSampled (input.get(), output.get(), effectiveAnalysisWidth, windowShape, subtractFrameMean);
-			autoVEC fourierSamples = raw_VEC (numberOfFourierSamples);
-			autoVEC onesidedPowerSpectrum = raw_VEC (numberOfFrequencies);
-			autoNUMFourierTable fourierTable = NUMFourierTable_create (numberOfFourierSamples);		// of dimension numberOfFourierSamples;
-			MelderThread_FOR (iframe) {
+		autoVEC window = raw_VEC (soundFrameSize);
+		windowShape_into_VEC (windowShape, window.get());
+		/*
+			The frames are analysed in blocks, so that each channel of a block
+			can be windowed and transformed by a single call to NUMfft_forward_batch.
+		*/
+		constexpr integer numberOfFramesPerBlock = 16;
+		const integer numberOfBlocks = (nFrames - 1) / numberOfFramesPerBlock + 1;
+		MelderThread_PARALLEL (numberOfBlocks, 1) {
+			autoMAT frames = raw_MAT (numberOfFramesPerBlock, numberOfFourierSamples);
+			autoMAT onesidedPowerSpectra = raw_MAT (numberOfFramesPerBlock, numberOfFrequencies);
+			autoINTVEC firstSamples = raw_INTVEC (numberOfFramesPerBlock);
+			sharedNUMFourierTable fourierTable = NUMFourierTable_getShared (numberOfFourierSamples);		// of dimension numberOfFourierSamples;
+			MelderThread_FOR (iblock) {
+				const integer firstFrame = (iblock - 1) * numberOfFramesPerBlock + 1;
+				const integer numberOfFramesInBlock = std::min (numberOfFramesPerBlock, nFrames - firstFrame + 1);
+				const MAT blockFrames (& frames [1] [1], numberOfFramesInBlock, numberOfFourierSamples);
+				const INTVEC blockFirstSamples = firstSamples.part (1, numberOfFramesInBlock);
+				for (integer iframe = 1; iframe <= numberOfFramesInBlock; iframe ++) {
+					const double midTime = Sampled_indexToX (output.get(), firstFrame - 1 + iframe);
+					blockFirstSamples [iframe] = Sampled_xToNearestIndex (input.get(), midTime - 0.5 * physicalAnalysisWidth); // approximation
+				}
 				/*
 					Get average power spectrum of channels
 					Let X(f) be the Fourier Transform, defined on the domain [-F,+F], of the real signal x(t).
@@ -64,40 +79,46 @@ autoPowerCepstrogram Sound_to_PowerCepstrogram (constSound me, double pitchFloor
 					The bin width of the first and last frequency in the onesidedPowerSpectrum is half the bin width at the other frequencies
 					Do scaling and averaging together
 				*/
-				Sound sound = soundFrames -> getFrame (iframe);
-				onesidedPowerSpectrum.get()  <<=  0.0;
+				onesidedPowerSpectra.all()  <<=  0.0;
 				for (integer ichannel = 1; ichannel <= numberOfChannels; ichannel ++) {
-					fourierSamples.part (1, soundFrameSize)  <<=  sound -> z.row (ichannel);
-					fourierSamples.part (soundFrameSize + 1, numberOfFourierSamples)  <<=  0.0;
-					NUMfft_forward (fourierTable.get(), fourierSamples.get());
-					onesidedPowerSpectrum [1] += fourierSamples [1] * fourierSamples [1];
-					for (integer i = 2; i < numberOfFrequencies; i ++) {
-						double re = fourierSamples [2 * i - 2], im = fourierSamples [2 * i - 1];
-						onesidedPowerSpectrum [i] += re * re + im * im;
+					NUMfft_forward_batch (fourierTable.get(), blockFrames,
+							input -> z.row (ichannel), blockFirstSamples, window.get(), subtractFrameMean);
+					for (integer iframe = 1; iframe <= numberOfFramesInBlock; iframe ++) {
+						const constVEC fourierSamples = blockFrames.row (iframe);
+						const VEC onesidedPowerSpectrum = onesidedPowerSpectra.row (iframe);
+						onesidedPowerSpectrum [1] += fourierSamples [1] * fourierSamples [1];
+						for (integer i = 2; i < numberOfFrequencies; i ++) {
+							double re = fourierSamples [2 * i - 2], im = fourierSamples [2 * i - 1];
+							onesidedPowerSpectrum [i] += re * re + im * im;
+						}
+						onesidedPowerSpectrum [numberOfFrequencies] += fourierSamples [numberOfFourierSamples] * fourierSamples [numberOfFourierSamples];
 					}
-					onesidedPowerSpectrum [numberOfFrequencies] += fourierSamples [numberOfFourierSamples] * fourierSamples [numberOfFourierSamples];
 				}
-				onesidedPowerSpectrum.get()  *=  2.0 * powerScaling / numberOfChannels; // scaling and averaging over channels
-				/*
-					Get log power.
-				*/
-				fourierSamples [1] = log (onesidedPowerSpectrum [1] + 1e-300);
-				for (integer i = 2; i < numberOfFrequencies; i ++) {
-					fourierSamples [2 * i - 2] = log (onesidedPowerSpectrum [i] + 1e-300);
-					fourierSamples [2 * i - 1] = 0.0;
+				for (integer iframe = 1; iframe <= numberOfFramesInBlock; iframe ++) {
+					const VEC fourierSamples = blockFrames.row (iframe);
+					const VEC onesidedPowerSpectrum = onesidedPowerSpectra.row (iframe);
+					onesidedPowerSpectrum  *=  2.0 * powerScaling / numberOfChannels; // scaling and averaging over channels
+					/*
+						Get log power.
+					*/
+					fourierSamples [1] = log (onesidedPowerSpectrum [1] + 1e-300);
+					for (integer i = 2; i < numberOfFrequencies; i ++) {
+						fourierSamples [2 * i - 2] = log (onesidedPowerSpectrum [i] + 1e-300);
+						fourierSamples [2 * i - 1] = 0.0;
+					}
+					fourierSamples [numberOfFourierSamples] = log (onesidedPowerSpectrum [numberOfFrequencies]);
+					/*
+						Inverse transform
+					*/
+					NUMfft_backward (fourierTable.get(), fourierSamples);
+					/*
+						scale first.
+					*/
+					const double df = 1.0 / (input -> dx * numberOfFourierSamples);
+					fourierSamples  *=  df;
+					for (integer i = 1; i <= numberOfFrequencies; i ++)
+						output -> z [i] [firstFrame - 1 + iframe] = fourierSamples [i] * fourierSamples [i];
 				}
-				fourierSamples [numberOfFourierSamples] = log (onesidedPowerSpectrum [numberOfFrequencies]);
-				/*
-					Inverse transform
-				*/
-				NUMfft_backward (fourierTable.get(), fourierSamples.get());
-				/*
-					scale first.
-				*/
-				const double df = 1.0 / (sound -> dx * numberOfFourierSamples);
-				fourierSamples.get()  *=  df;
-				for (integer i = 1; i <= numberOfFrequencies; i ++)
-					output -> z [i] [iframe] = fourierSamples [i] * fourierSamples [i];
 			}
 		} MelderThread_ENDPARALLEL
 		return output;
@@ -164,7 +185,7 @@ autoPowerCepstrogram Sound_to_PowerCepstrogram_hillenbrand (constSound me, doubl
 		const integer nfftdiv2 = nfft / 2;
 		autoVEC fftbuf = zero_VEC (nfft); // "complex" array
 		autoVEC spectrum = zero_VEC (nfftdiv2 + 1); // +1 needed 
-		autoNUMFourierTable fftTable = NUMFourierTable_create (nfft); // sound to spectrum
+		sharedNUMFourierTable fftTable = NUMFourierTable_getShared (nfft); // sound to spectrum
 		
 		const double qmax = 0.5 * nfft / samplingFrequency, dq = qmax / (nfftdiv2 + 1);
 		autoPowerCepstrogram him = PowerCepstrogram_create (my xmin, my xmax, numberOfFrames, dt, t1, 0, qmax, nfftdiv2+1, dq, 0);
@@ -130,14 +130,14 @@ void VECsmoothByMovingAverage_preallocated (VECVU const& out, constVECVU const&
 	}
 }
 
-void VECsmooth_gaussian (VECVU const& out, constVECVU const& in, double sigma, NUMFourierTable fftTable) {
+void VECsmooth_gaussian (VECVU const& out, constVECVU const& in, double sigma, constNUMFourierTable fftTable) {
 	Melder_require (out.size == in.size,
 		U"The sizes of the input and output vectors should be equal.");
 	out  <<=  in;
 	VECsmooth_gaussian_inplace (out, sigma, fftTable);
 }
 
-void VECsmooth_gaussian_inplace (VECVU const& in_out, double sigma, NUMFourierTable fftTable) {
+void VECsmooth_gaussian_inplace (VECVU const& in_out, double sigma, constNUMFourierTable fftTable) {
 	Melder_require (in_out.size <= fftTable -> n,
 		U"The dimension of the table should at least equal the length of the input vector.");
 	autoVEC smooth = zero_VEC (fftTable -> n);
@@ -171,7 +171,7 @@ void VECsmooth_gaussian_inplace (VECVU const& in_out, double sigma, NUMFourierTa
 
 void VECsmooth_gaussian_inplace (VECVU const& in_out, double sigma) {
 	const integer nfft = Melder_iroundUpToPowerOfTwo (in_out.size);
-	autoNUMFourierTable fftTable = NUMFourierTable_create (nfft);
+	sharedNUMFourierTable fftTable = NUMFourierTable_getShared (nfft);
 	VECsmooth_gaussian_inplace (in_out, sigma, fftTable.get());
 }
 
@@ -899,8 +899,8 @@ double NUMminimize_brent (double (*f) (double x, void *closure), double a, doubl
 */
 
 void VECsmooth_gaussian_inplace (VECVU const& in_out, double sigma);
-void VECsmooth_gaussian_inplace (VECVU const& in_out, double sigma, NUMFourierTable fftTable);
-void VECsmooth_gaussian (VECVU const& out, constVECVU const& in, double sigma, NUMFourierTable fftTable);
+void VECsmooth_gaussian_inplace (VECVU const& in_out, double sigma, constNUMFourierTable fftTable);
+void VECsmooth_gaussian (VECVU const& out, constVECVU const& in, double sigma, constNUMFourierTable fftTable);
 /*
 	Smooth the vector 'in/in_out' by convolving with a Gaussian, i.e. convolve with gaussian by
 	using the Fourier Transform. Normally an FFT is used unless otherwise specified in 'fftTable"
@@ -1,6 +1,6 @@
 /* NUMFourier.cpp
  *
- * Copyright (C) 1997-2011,2025 David Weenink, Paul Boersma 2016-2018,2020
+ * Copyright (C) 1997-2011,2025 David Weenink, Paul Boersma 2016-2018,2020,2026
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,6 +17,7 @@
  */
 
 #include "NUMFourier.h"
+#include <map>
 
 #include "oo_DESTROY.h"
 #include "NUMFourierTable_def.h"
@@ -42,24 +43,367 @@
 
 Thing_implement (NUMFourierTable, Daata, 0);
 
-autoNUMFourierTable NUMFourierTable_create (integer n) {
+/*
+	The mixed-radix transform, once with 16-byte vectors (SSE2 on Intel64 and AMD64, Neon on ARM64),
+	and on Intel64 and AMD64 once more with 32-byte vectors (AVX2), for processors that turn out to have AVX2 and FMA
+	(or for all processors, if Praat was compiled for x86-64-v3).
+*/
+namespace NUMfft_vector16 {
+	#define FFT_VECTOR_BYTES  16
+	#include "NUMfft_stockham.h"
+	#undef FFT_VECTOR_BYTES
+}
+#if defined (__x86_64__) && (defined (__GNUC__) || defined (__clang__))
+	#define NUMfft_HAVE_VECTOR32  1
+	#if ! defined (__clang__)
+		#pragma GCC diagnostic ignored "-Wpsabi"   // no 32-byte vectors are passed between AVX2 and non-AVX2 functions
+	#endif
+	#if ! defined (__AVX2__)
+		#define NUMfft_CHECK_VECTOR32_AT_RUN_TIME  1
+		#if defined (__clang__)
+			#pragma clang attribute push (__attribute__ ((target ("avx2,fma"))), apply_to = function)
+		#else
+			#pragma GCC push_options
+			#pragma GCC target ("avx2,fma")
+		#endif
+	#endif
+	namespace NUMfft_vector32 {
+		#define FFT_VECTOR_BYTES  32
+		#include "NUMfft_stockham.h"
+		#undef FFT_VECTOR_BYTES
+	}
+	#if defined (NUMfft_CHECK_VECTOR32_AT_RUN_TIME)
+		#if defined (__clang__)
+			#pragma clang attribute pop
+		#else
+			#pragma GCC pop_options
+		#endif
+	#endif
+#endif
+
+static bool useVector32 () {
+	if (Melder_debug == 60)
+		return false;
+	#if defined (NUMfft_CHECK_VECTOR32_AT_RUN_TIME)
+		static const bool processorHasAvx2 = __builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma");
+		return processorHasAvx2;
+	#elif defined (NUMfft_HAVE_VECTOR32)
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+conststring32 NUMfft_instructionSet () {
+	#if defined (NUMfft_HAVE_VECTOR32)
+		if (useVector32 ())
+			return U"AVX2";
+	#endif
+	#if defined (__x86_64__)
+		return U"SSE2";
+	#elif defined (__aarch64__)
+		return U"Neon";
+	#else
+		return U"generic";
+	#endif
+}
+
+/*
+	The mixed-radix transform handles n = 2 m, where m > 1 consists of factors 2, 3, 5 and other primes
+	up to NUMfft_MAXIMUM_GENERAL_RADIX; we use as many radix-4 stages as possible.
+	Returns the number of factors, or 0 if n cannot be handled.
+*/
+static integer mixedRadixFactors (integer n, integer factors [64]) {
+	if (n % 2 != 0 || n < 4)
+		return 0;
+	integer m = n / 2, numberOfFactors = 0;
+	while (m % 4 == 0) {
+		factors [numberOfFactors ++] = 4;
+		m /= 4;
+	}
+	if (m % 2 == 0) {
+		factors [numberOfFactors ++] = 2;
+		m /= 2;
+	}
+	for (integer p = 3; p <= NUMfft_vector16::NUMfft_MAXIMUM_GENERAL_RADIX; p += 2) {
+		while (m % p == 0) {
+			factors [numberOfFactors ++] = p;
+			m /= p;
+		}
+	}
+	return ( m == 1 ? numberOfFactors : 0 );
+}
+
+/*
+	The twiddles of a complex transform of size m, followed by those for combining real data of size my n.
+*/
+static void computeTwiddles (NUMFourierTable me, integer m) {
+	integer size = 0, currentSize = m;
+	for (integer ifactor = 1; ifactor <= my numberOfFactors; ifactor ++) {
+		const integer p = my factors [ifactor];
+		size += 2 * (p - 1) * (currentSize / p) + ( p > 5 ? 2 * p : 0 );
+		currentSize /= p;
+	}
+	size += 2 * (my n / 4 + 1);
+	my twiddlesSize = size;
+	my twiddles = raw_VEC (size);
+	double *twiddle = & my twiddles [1];
+	currentSize = m;
+	for (integer ifactor = 1; ifactor <= my numberOfFactors; ifactor ++) {
+		const integer p = my factors [ifactor], mm = currentSize / p;
+		for (integer k = 1; k < p; k ++) {
+			for (integer pp = 0; pp < mm; pp ++) {
+				const double angle = -2.0 * NUMpi * (double) (k * pp % currentSize) / currentSize;
+				*twiddle ++ = cos (angle);
+				*twiddle ++ = sin (angle);
+			}
+		}
+		if (p > 5) {
+			for (integer j = 0; j < p; j ++) {
+				const double angle = 2.0 * NUMpi * j / p;
+				*twiddle ++ = cos (angle);
+				*twiddle ++ = sin (angle);
+			}
+		}
+		currentSize /= p;
+	}
+	for (integer k = 0; k <= my n / 4; k ++) {
+		const double angle = -2.0 * NUMpi * k / my n;
+		*twiddle ++ = cos (angle);
+		*twiddle ++ = sin (angle);
+	}
+	Melder_assert (twiddle == & my twiddles [1] + size);
+}
+
+static void setFactors (NUMFourierTable me, integer numberOfFactors, const integer factors [64]) {
+	my numberOfFactors = numberOfFactors;
+	my factors = raw_INTVEC (numberOfFactors);
+	for (integer ifactor = 1; ifactor <= numberOfFactors; ifactor ++)
+		my factors [ifactor] = factors [ifactor - 1];
+}
+
+/*
+	FFTPACK handles the factors 2, 3, 4 and 5 efficiently, but needs of the order of p operations per sample
+	for every other prime factor p. Bluestein's algorithm needs two complex transforms of a size
+	of between two and four times the number of complex numbers, independently of the factors,
+	so it turns out to be faster if the larger factors add up to more than about 30.
+*/
+constexpr integer NUMfft_MINIMUM_BLUESTEIN_COST = 32;
+
+static bool bluesteinIsFaster (integer n) {
+	if (n < 8)
+		return false;
+	if (Melder_debug == 61)
+		return true;
+	integer remainder = n, costOfLargeFactors = 0;
+	for (integer p = 2; p <= 5; p ++)
+		while (remainder % p == 0)
+			remainder /= p;
+	for (integer p = 7; p * p <= remainder; p += 2) {
+		while (remainder % p == 0) {
+			costOfLargeFactors += p;
+			remainder /= p;
+		}
+	}
+	if (remainder > 1)
+		costOfLargeFactors += remainder;   // a prime
+	return costOfLargeFactors >= NUMfft_MINIMUM_BLUESTEIN_COST;
+}
+
+/*
+	The smallest M >= minimumSize that consists of factors 2, 3 and 5 only.
+*/
+static integer convolutionSize (integer minimumSize) {
+	integer best = Melder_iroundUpToPowerOfTwo (minimumSize);
+	for (integer power3 = 1; power3 < best; power3 *= 3) {
+		for (integer power35 = power3; power35 < best; power35 *= 5) {
+			integer candidate = power35;
+			while (candidate < minimumSize)
+				candidate *= 2;
+			if (candidate < best)
+				best = candidate;
+		}
+	}
+	return best;
+}
+
+static void initBluestein (NUMFourierTable me) {
+	const integer L = ( my n % 2 == 0 ? my n / 2 : my n );   // the size of the complex transform
+	const integer M = convolutionSize (std::max (2 * L - 1, 2_integer));
+	my convolutionSize = M;
+	integer factors [64];
+	const integer numberOfFactors = mixedRadixFactors (2 * M, factors);
+	Melder_assert (numberOfFactors > 0);
+	setFactors (me, numberOfFactors, factors);
+	computeTwiddles (me, M);
+	/*
+		The chirp c [j] = exp (-pi i j^2 / L), where j^2 is reduced modulo 2 L for precision.
+	*/
+	my chirpSize = 2 * L;
+	my chirp = raw_VEC (my chirpSize);
+	for (integer j = 0; j < L; j ++) {
+		const double angle = -NUMpi * (double) (j * j % (2 * L)) / L;
+		my chirp [2 * j + 1] = cos (angle);
+		my chirp [2 * j + 2] = sin (angle);
+	}
+	/*
+		The transform of conj (c), wrapped around, divided by M.
+	*/
+	my chirpSpectrumSize = 2 * M;
+	my chirpSpectrum = zero_VEC (my chirpSpectrumSize);
+	for (integer j = 0; j < L; j ++) {
+		my chirpSpectrum [2 * j + 1] = my chirp [2 * j + 1];
+		my chirpSpectrum [2 * j + 2] = - my chirp [2 * j + 2];
+		if (j > 0) {
+			my chirpSpectrum [2 * (M - j) + 1] = my chirp [2 * j + 1];
+			my chirpSpectrum [2 * (M - j) + 2] = - my chirp [2 * j + 2];
+		}
+	}
+	autoVEC work = raw_VEC (my chirpSpectrumSize);
+	const double *spectrum = NUMfft_vector16::complexTransform <double, -1> (M, my factors.get(), & my twiddles [1],
+			& my chirpSpectrum [1], & work [1]);
+	if (spectrum != & my chirpSpectrum [1])
+		my chirpSpectrum.all()  <<=  work.all();
+	my chirpSpectrum.all()  *=  1.0 / M;
+}
+
+static autoNUMFourierTable NUMFourierTable_create_ (integer n, bool mixedRadix) {
 	try {
 		autoNUMFourierTable me = Thing_new (NUMFourierTable);
 		my n = n;
-		my trigcacheSize = 3 * n;
-		my trigcache = zero_VEC (my trigcacheSize);
-		my splitcacheSize = 32;
-		my splitcache = zero_INTVEC (my splitcacheSize);
-		NUMrffti (n, my trigcache.asArgumentToFunctionThatExpectsZeroBasedArray(),
-			my splitcache.asArgumentToFunctionThatExpectsZeroBasedArray());
+		integer factors [64];
+		const integer numberOfFactors = ( mixedRadix ? mixedRadixFactors (n, factors) : 0 );
+		if (numberOfFactors > 0) {
+			setFactors (me.get(), numberOfFactors, factors);
+			computeTwiddles (me.get(), n / 2);
+		} else if (mixedRadix && bluesteinIsFaster (n)) {
+			initBluestein (me.get());
+		} else {
+			my trigcacheSize = 3 * n;
+			my trigcache = zero_VEC (my trigcacheSize);
+			my splitcacheSize = 32;
+			my splitcache = zero_INTVEC (my splitcacheSize);
+			NUMrffti (n, my trigcache.asArgumentToFunctionThatExpectsZeroBasedArray(),
+				my splitcache.asArgumentToFunctionThatExpectsZeroBasedArray());
+		}
 		return me;
 	} catch (MelderError) {
 		Melder_throw (U"Cannot create NUMFourierTable.");
 	}
 }
 
+autoNUMFourierTable NUMFourierTable_create (integer n) {
+	return NUMFourierTable_create_ (n, Melder_debug != 59);
+}
+
+autoNUMFourierTable NUMFourierTable_create_fftpack (integer n) {
+	return NUMFourierTable_create_ (n, false);
+}
+
+/*
+	The process-wide cache of tables, keyed by size.
+	The cache owns a reference to each of its tables, and every user of a table owns another;
+	a table is deleted when its last reference goes away.
+*/
+struct FourierTableCacheEntry {
+	sharedNUMFourierTable table;
+	integer numberOfBytes;
+	int64 lastUse;
+};
+static struct {
+	std::mutex mutex;
+	std::map <integer, FourierTableCacheEntry> entries;
+	int64 clock = 0;   // the number of times the cache was asked for a table
+	integer numberOfBytes = 0;
+	integer budget = 64 * 1024 * 1024;   // enough for all frame sizes of a session, plus some whole-sound sizes
+	integer numberOfHits = 0, numberOfMisses = 0, numberOfDroppedTables = 0;
+} theCache;
+
+static integer numberOfBytesInTable (constNUMFourierTable me) {
+	return (integer) sizeof (structNUMFourierTable)
+		+ (my trigcacheSize + my twiddlesSize + my chirpSize + my chirpSpectrumSize) * (integer) sizeof (double)
+		+ (my splitcacheSize + my numberOfFactors) * (integer) sizeof (integer);
+}
+
+static sharedNUMFourierTable share (autoNUMFourierTable table) {
+	return sharedNUMFourierTable (table.releaseToAmbiguousOwner(),
+			[] (constNUMFourierTable me) { _Thing_forget (const_cast <NUMFourierTable> (me)); });
+}
+
+/*
+	Drop the least recently used tables until the rest fits within the budget.
+	To be called with the mutex locked.
+*/
+static void cache_shrink () {
+	while (theCache.numberOfBytes > theCache.budget && ! theCache.entries.empty ()) {
+		auto oldest = theCache.entries.begin ();
+		for (auto entry = theCache.entries.begin (); entry != theCache.entries.end (); ++ entry)
+			if (entry -> second.lastUse < oldest -> second.lastUse)
+				oldest = entry;
+		theCache.numberOfBytes -= oldest -> second.numberOfBytes;
+		theCache.entries.erase (oldest);   // the table itself lives on in its current users, if any
+		theCache.numberOfDroppedTables += 1;
+	}
+}
+
+sharedNUMFourierTable NUMFourierTable_getShared (integer n) {
+	if (Melder_debug == 59 || Melder_debug == 61)
+		return share (NUMFourierTable_create (n));   // such tables are for testing only, so they should not stay around
+	{// scope
+		std::lock_guard <std::mutex> lock (theCache.mutex);
+		auto entry = theCache.entries.find (n);
+		if (entry != theCache.entries.end ()) {
+			theCache.numberOfHits += 1;
+			entry -> second.lastUse = ++ theCache.clock;
+			return entry -> second.table;
+		}
+		theCache.numberOfMisses += 1;
+	}
+	/*
+		Compute the table without holding the lock, so that other threads can use the cache meanwhile.
+		If another thread happens to compute a table of the same size at the same time,
+		the first table to arrive is kept.
+	*/
+	sharedNUMFourierTable table = share (NUMFourierTable_create (n));
+	const integer numberOfBytes = numberOfBytesInTable (table.get());
+	std::lock_guard <std::mutex> lock (theCache.mutex);
+	auto [entry, isNew] = theCache.entries.emplace (n, FourierTableCacheEntry { table, numberOfBytes, ++ theCache.clock });
+	if (! isNew)
+		return entry -> second.table;
+	theCache.numberOfBytes += numberOfBytes;
+	cache_shrink ();   // this may drop the new table as well, if it is larger than the whole budget
+	return table;
+}
+
+NUMFourierTableCacheStatistics NUMFourierTable_getCacheStatistics () {
+	std::lock_guard <std::mutex> lock (theCache.mutex);
+	NUMFourierTableCacheStatistics statistics;
+	statistics.numberOfHits = theCache.numberOfHits;
+	statistics.numberOfMisses = theCache.numberOfMisses;
+	statistics.numberOfDroppedTables = theCache.numberOfDroppedTables;
+	statistics.numberOfTables = uinteger_to_integer_a (theCache.entries.size ());
+	statistics.numberOfBytes = theCache.numberOfBytes;
+	statistics.budget = theCache.budget;
+	return statistics;
+}
+
+void NUMFourierTable_setCacheBudget (integer numberOfBytes) {
+	Melder_require (numberOfBytes >= 0,
+		U"The memory budget for Fourier tables should not be negative.");
+	std::lock_guard <std::mutex> lock (theCache.mutex);
+	theCache.budget = numberOfBytes;
+	cache_shrink ();
+}
+
+void NUMFourierTable_clearCache () {
+	std::lock_guard <std::mutex> lock (theCache.mutex);
+	theCache.entries.clear ();
+	theCache.numberOfBytes = 0;
+	theCache.numberOfHits = theCache.numberOfMisses = theCache.numberOfDroppedTables = 0;
+}
+
 void NUMforwardRealFastFourierTransform (VEC data) {
-	autoNUMFourierTable table = NUMFourierTable_create (data.size);
+	sharedNUMFourierTable table = NUMFourierTable_getShared (data.size);
 	NUMfft_forward (table.get(), data);
 	if (data.size > 1) {
 		/*
@@ -82,14 +426,61 @@ void NUMreverseRealFastFourierTransform (VEC data) {
 			data [i] = data [i + 1];
 		data [data.size] = tmp;
 	}
-	autoNUMFourierTable table = NUMFourierTable_create (data.size);
+	sharedNUMFourierTable table = NUMFourierTable_getShared (data.size);
 	NUMfft_backward (table.get(), data);
 }
 
-void NUMfft_forward (NUMFourierTable me, VEC data) {
+/*
+	The mixed-radix transform needs scratch memory of the size of the data.
+	This is kept per thread, so that a table can be used by several threads at the same time,
+	and only for smaller sizes, which are typically transformed many times in a row.
+*/
+template <typename T>
+static T *workspace (integer n, autovector <T>& largeWorkspace) {
+	constexpr integer maximumKeptSize = 65536;
+	if (n > maximumKeptSize) {
+		largeWorkspace = newvectorraw <T> (n);
+		return & largeWorkspace [1];
+	}
+	static thread_local autovector <T> keptWorkspace;
+	if (keptWorkspace.size < n)
+		keptWorkspace = newvectorraw <T> (n);
+	return & keptWorkspace [1];
+}
+
+#if ! defined (NUMfft_HAVE_VECTOR32)
+	namespace NUMfft_vector32 = NUMfft_vector16;
+#endif
+#define NUMfft_CHOOSE(function)  ( useVector32 () ? & NUMfft_vector32::function : & NUMfft_vector16::function )
+
+static const double *realTwiddles (constNUMFourierTable me) {
+	return & my twiddles [my twiddlesSize - 2 * (my n / 4 + 1) + 1];
+}
+
+/*
+	Bluestein's algorithm needs scratch memory for two transforms of the convolution size and for the complex data.
+*/
+static integer bluesteinWorkspaceSize (constNUMFourierTable me) {
+	return 4 * my convolutionSize + 2 * my n;
+}
+
+void NUMfft_forward (constNUMFourierTable me, VEC data) {
 	if (my n == 1)
 		return;
 	Melder_assert (my n == data.size);
+	if (my convolutionSize > 0) {
+		autovector <double> largeWorkspace;
+		double *work = workspace <double> (bluesteinWorkspaceSize (me), largeWorkspace);
+		NUMfft_CHOOSE (realForwardBluestein_double) (my n, my convolutionSize, my factors.get(), & my twiddles [1], realTwiddles (me),
+				& my chirp [1], & my chirpSpectrum [1], & data [1], work);
+		return;
+	}
+	if (my numberOfFactors > 0) {
+		autovector <double> largeWorkspace;
+		double *work = workspace <double> (my n, largeWorkspace);
+		NUMfft_CHOOSE (realForward_double) (my n, my factors.get(), & my twiddles [1], realTwiddles (me), & data [1], work, false);
+		return;
+	}
 	drftf1 (my n, data.asArgumentToFunctionThatExpectsZeroBasedArray(),
 		my trigcache.asArgumentToFunctionThatExpectsZeroBasedArray(),
 		my trigcache.asArgumentToFunctionThatExpectsZeroBasedArray() + my n,
@@ -97,10 +488,23 @@ void NUMfft_forward (NUMFourierTable me, VEC data) {
 	);
 }
 
-void NUMfft_backward (NUMFourierTable me, VEC data) {
+void NUMfft_backward (constNUMFourierTable me, VEC data) {
 	if (my n == 1)
 		return;
 	Melder_assert (my n == data.size);
+	if (my convolutionSize > 0) {
+		autovector <double> largeWorkspace;
+		double *work = workspace <double> (bluesteinWorkspaceSize (me), largeWorkspace);
+		NUMfft_CHOOSE (realBackwardBluestein_double) (my n, my convolutionSize, my factors.get(), & my twiddles [1], realTwiddles (me),
+				& my chirp [1], & my chirpSpectrum [1], & data [1], work);
+		return;
+	}
+	if (my numberOfFactors > 0) {
+		autovector <double> largeWorkspace;
+		double *work = workspace <double> (my n, largeWorkspace);
+		NUMfft_CHOOSE (realBackward_double) (my n, my factors.get(), & my twiddles [1], realTwiddles (me), & data [1], work);
+		return;
+	}
 	drftb1 (my n, data.asArgumentToFunctionThatExpectsZeroBasedArray(),
 		my trigcache.asArgumentToFunctionThatExpectsZeroBasedArray(),
 		my trigcache.asArgumentToFunctionThatExpectsZeroBasedArray() + my n,
@@ -108,6 +512,121 @@ void NUMfft_backward (NUMFourierTable me, VEC data) {
 	);
 }
 
+/*
+	In single precision, sizes that neither the mixed-radix transform nor Bluestein's algorithm handles
+	go through FFTPACK in double precision.
+*/
+static void fftpackInDoublePrecision (constNUMFourierTable me, vector <float> const& data, void (*transform) (constNUMFourierTable, VEC)) {
+	autoVEC copy = raw_VEC (data.size);
+	for (integer i = 1; i <= data.size; i ++)
+		copy [i] = data [i];
+	transform (me, copy.get());
+	for (integer i = 1; i <= data.size; i ++)
+		data [i] = (float) copy [i];
+}
+
+void NUMfft_forward (constNUMFourierTable me, vector <float> const& data) {
+	if (my n == 1)
+		return;
+	Melder_assert (my n == data.size);
+	if (my numberOfFactors == 0)
+		return fftpackInDoublePrecision (me, data, NUMfft_forward);
+	autovector <float> largeWorkspace;
+	if (my convolutionSize > 0) {
+		float *work = workspace <float> (bluesteinWorkspaceSize (me), largeWorkspace);
+		NUMfft_CHOOSE (realForwardBluestein_float) (my n, my convolutionSize, my factors.get(), & my twiddles [1], realTwiddles (me),
+				& my chirp [1], & my chirpSpectrum [1], & data [1], work);
+		return;
+	}
+	float *work = workspace <float> (my n, largeWorkspace);
+	NUMfft_CHOOSE (realForward_float) (my n, my factors.get(), & my twiddles [1], realTwiddles (me), & data [1], work, false);
+}
+
+void NUMfft_backward (constNUMFourierTable me, vector <float> const& data) {
+	if (my n == 1)
+		return;
+	Melder_assert (my n == data.size);
+	if (my numberOfFactors == 0)
+		return fftpackInDoublePrecision (me, data, NUMfft_backward);
+	autovector <float> largeWorkspace;
+	if (my convolutionSize > 0) {
+		float *work = workspace <float> (bluesteinWorkspaceSize (me), largeWorkspace);
+		NUMfft_CHOOSE (realBackwardBluestein_float) (my n, my convolutionSize, my factors.get(), & my twiddles [1], realTwiddles (me),
+				& my chirp [1], & my chirpSpectrum [1], & data [1], work);
+		return;
+	}
+	float *work = workspace <float> (my n, largeWorkspace);
+	NUMfft_CHOOSE (realBackward_float) (my n, my factors.get(), & my twiddles [1], realTwiddles (me), & data [1], work);
+}
+
+void NUMfft_forward_batch (constNUMFourierTable me, MAT const& frames) {
+	Melder_assert (frames.ncol == my n);
+	if (my n == 1)
+		return;
+	if (my numberOfFactors == 0 || my convolutionSize > 0) {
+		for (integer iframe = 1; iframe <= frames.nrow; iframe ++)
+			NUMfft_forward (me, frames.row (iframe));
+		return;
+	}
+	autovector <double> largeWorkspace;
+	double *work = workspace <double> (my n, largeWorkspace);
+	const auto transform = NUMfft_CHOOSE (realForward_double);
+	for (integer iframe = 1; iframe <= frames.nrow; iframe ++)
+		transform (my n, my factors.get(), & my twiddles [1], realTwiddles (me), & frames [iframe] [1], work, false);
+}
+
+/*
+	Copy a frame of `samples` into `frame`, starting at `firstSample`, with zeroes outside `samples`,
+	and with the frame mean subtracted (if requested) before windowing; pad with zeroes.
+*/
+static void windowIntoFrame (constVEC const& samples, integer firstSample, constVEC const& window, bool subtractFrameMean, VEC const& frame) {
+	const integer frameSize = window.size;
+	const integer offset = firstSample - 1;
+	const integer firstInside = Melder_clipped (1_integer, 1 - offset, frameSize + 1);
+	const integer lastInside = Melder_clipped (firstInside - 1, samples.size - offset, frameSize);
+	for (integer j = 1; j < firstInside; j ++)
+		frame [j] = 0.0;
+	if (subtractFrameMean) {
+		for (integer j = firstInside; j <= lastInside; j ++)
+			frame [j] = samples [offset + j];
+		for (integer j = lastInside + 1; j <= frameSize; j ++)
+			frame [j] = 0.0;
+		const double mean = NUMmean (frame.part (1, frameSize));
+		for (integer j = 1; j <= frameSize; j ++)
+			frame [j] = (frame [j] - mean) * window [j];
+	} else {
+		for (integer j = firstInside; j <= lastInside; j ++)
+			frame [j] = samples [offset + j] * window [j];
+		for (integer j = lastInside + 1; j <= frameSize; j ++)
+			frame [j] = 0.0;
+	}
+	frame.part (frameSize + 1, frame.size)  <<=  0.0;
+}
+
+void NUMfft_forward_batch (constNUMFourierTable me, MAT const& frames,
+	constVEC const& samples, constINTVEC const& firstSamples, constVEC const& window, bool subtractFrameMean)
+{
+	Melder_assert (frames.ncol == my n);
+	Melder_assert (firstSamples.size == frames.nrow);
+	Melder_assert (window.size <= my n);
+	if (my numberOfFactors == 0 || my convolutionSize > 0) {
+		for (integer iframe = 1; iframe <= frames.nrow; iframe ++) {
+			windowIntoFrame (samples, firstSamples [iframe], window, subtractFrameMean, frames.row (iframe));
+			NUMfft_forward (me, frames.row (iframe));
+		}
+		return;
+	}
+	autovector <double> largeWorkspace;
+	double *work = workspace <double> (my n, largeWorkspace);
+	const bool inputIsInWork = NUMfft_vector16::firstStageReadsWork (my factors.get());
+	const auto transform = NUMfft_CHOOSE (realForward_double);
+	for (integer iframe = 1; iframe <= frames.nrow; iframe ++) {
+		const VEC input = ( inputIsInWork ? VEC (work, my n) : frames.row (iframe) );
+		windowIntoFrame (samples, firstSamples [iframe], window, subtractFrameMean, input);
+		transform (my n, my factors.get(), & my twiddles [1], realTwiddles (me), & frames [iframe] [1], work, inputIsInWork);
+	}
+}
+
 void NUMrealft (VEC data, integer isign) {
 	if (isign == 1)
 		NUMforwardRealFastFourierTransform (data);
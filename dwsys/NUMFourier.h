@@ -2,7 +2,7 @@
 #define _NUMFourier_h_
 /* NUMFourier.h
  *
- * Copyright (C) 2025 David Weenink
+ * Copyright (C) 2025 David Weenink, 2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -23,8 +23,41 @@
 #include "NUMFourierTable_def.h"
 
 autoNUMFourierTable NUMFourierTable_create (integer n);
+/*
+	If n is even and n/2 consists of factors 2, 3, 5, 7, 11 and 13 only,
+	the table is for a vectorized mixed-radix transform (see NUMfft_stockham.h);
+	otherwise, if n has large prime factors, for Bluestein's algorithm on top of that transform,
+	so that every size takes of the order of n log n operations;
+	otherwise for FFTPACK. A table does not change during a transform,
+	so it can be shared by several threads.
+*/
+
+autoNUMFourierTable NUMFourierTable_create_fftpack (integer n);   // for comparison only
+
+using sharedNUMFourierTable = std::shared_ptr <const structNUMFourierTable>;
+
+sharedNUMFourierTable NUMFourierTable_getShared (integer n);
+/*
+	The same table as NUMFourierTable_create (n) would give, but from a process-wide cache,
+	so that analyses that transform many frames of the same size, in any number of threads
+	and in any number of successive commands, compute the table only once.
+	The table is shared and cannot be changed. It stays alive as long as somebody uses it,
+	even if the cache has dropped it in the meantime (the cache drops the least recently used tables
+	as soon as the tables together take up more memory than the budget).
+	Thread-safe.
+*/
+
+struct NUMFourierTableCacheStatistics {
+	integer numberOfHits, numberOfMisses, numberOfDroppedTables;   // since the last clear
+	integer numberOfTables, numberOfBytes, budget;   // currently
+};
+NUMFourierTableCacheStatistics NUMFourierTable_getCacheStatistics ();
+void NUMFourierTable_setCacheBudget (integer numberOfBytes);   // drops tables if necessary
+void NUMFourierTable_clearCache ();   // drops all tables and resets the counts
+
+conststring32 NUMfft_instructionSet ();   // "AVX2", "SSE2", "Neon" or "generic"
 
-void NUMfft_forward (NUMFourierTable table, VEC data);
+void NUMfft_forward (constNUMFourierTable table, VEC data);
 /*
 	Function:
 		Calculates the Fourier Transform of a set of n real-valued data points.
@@ -63,7 +96,7 @@ void NUMfft_forward (NUMFourierTable table, VEC data);
 	followed by a call of NUMfft_backward will multiply the input sequence by n.
 */
 
-void NUMfft_backward (NUMFourierTable table, VEC data);
+void NUMfft_backward (constNUMFourierTable table, VEC data);
 /*
 	Function:
 		Calculates the inverse transform of a complex array if it is the transform of real data.
@@ -98,6 +131,26 @@ void NUMfft_backward (NUMFourierTable table, VEC data);
 	sequence by n.
 */
 
+void NUMfft_forward (constNUMFourierTable table, vector <float> const& data);
+void NUMfft_backward (constNUMFourierTable table, vector <float> const& data);
+/*
+	The same in single precision, which is faster, but only about 1e-7 precise.
+*/
+
+void NUMfft_forward_batch (constNUMFourierTable table, MAT const& frames);
+/*
+	Transforms each row of `frames`, which has table -> n columns, as NUMfft_forward would.
+*/
+
+void NUMfft_forward_batch (constNUMFourierTable table, MAT const& frames,
+	constVEC const& samples, constINTVEC const& firstSamples, constVEC const& window, bool subtractFrameMean);
+/*
+	Fills row `iframe` of `frames` with the window.size samples from samples [firstSamples [iframe]] on
+	(samples outside `samples` count as zero), minus their mean if `subtractFrameMean` is true,
+	times `window`, followed by zeroes; then transforms the row, as NUMfft_forward would.
+	The windowed frame is written directly where the transform first reads it.
+*/
+
 
 /**** Compatibility with NR fft's */
 
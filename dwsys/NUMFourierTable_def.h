@@ -1,6 +1,6 @@
 /* NUMFourierTable_def.h
  *
- * Copyright (C) 2025 David Weenink
+ * Copyright (C) 2025 David Weenink, 2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -24,6 +24,24 @@ oo_DEFINE_CLASS (NUMFourierTable, Daata)
 	oo_INTEGER (splitcacheSize)
 	oo_VEC (trigcache, trigcacheSize)
 	oo_INTVEC (splitcache, splitcacheSize)
+	/*
+		The factors and twiddles of the mixed-radix transform (see NUMfft_stockham.h);
+		numberOfFactors is 0 if n is not supported by that transform, in which case the above caches are used.
+	*/
+	oo_INTEGER (numberOfFactors)
+	oo_INTVEC (factors, numberOfFactors)
+	oo_INTEGER (twiddlesSize)
+	oo_VEC (twiddles, twiddlesSize)
+	/*
+		For sizes with large prime factors, Bluestein's algorithm (see NUMfft_stockham.h);
+		the factors and twiddles above are then those of the convolution, which has convolutionSize complex numbers.
+		convolutionSize is 0 if Bluestein's algorithm is not used.
+	*/
+	oo_INTEGER (convolutionSize)
+	oo_INTEGER (chirpSize)
+	oo_VEC (chirp, chirpSize)
+	oo_INTEGER (chirpSpectrumSize)
+	oo_VEC (chirpSpectrum, chirpSpectrumSize)
 
 oo_END_CLASS (NUMFourierTable)
 #undef ooSTRUCT
@@ -0,0 +1,587 @@
+/* NUMfft_stockham.h
+ *
+ * Copyright (C) 2026 Paul Boersma
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+	A mixed-radix complex FFT in the self-sorting ("Stockham") formulation,
+	with radix-2, radix-3, radix-4 and radix-5 butterflies and a general butterfly for other small odd factors,
+	and the real-data transforms of NUMfft_forward and NUMfft_backward built on top of it,
+	directly or (for sizes with large prime factors) through Bluestein's algorithm.
+
+	Like NUMfft_core.h, this file is included by NUMFourier.cpp, but more than once:
+	every time inside a namespace of its own, and with FFT_VECTOR_BYTES defined as the size of
+	the vector registers of an instruction set (16 for SSE2 and Neon, 32 for AVX2).
+	The vectors are the vector extensions of GCC and Clang, which the compiler translates
+	into the instructions of the target. A vector holds one or more complex numbers,
+	stored as real part, imaginary part, real part, imaginary part...
+
+	The complex transform of size m goes through one stage per factor p of m.
+	A stage with "current size" n (m, m/p1, m/p1/p2...) and "stride" s (1, p1, p1 p2...)
+	does, for every 0 <= pp < n/p and every 0 <= q < s,
+		a [r] = x [q + s * (pp + r * n/p)]   for 0 <= r < p
+		y [q + s * (p * pp + k)] = w^k * sum_r a [r] * exp (-2 pi i r k / p)   for 0 <= k < p
+	where w = exp (-2 pi i pp / n) is the "twiddle" factor (conjugated for the backward transform).
+	If s is at least the number of complex numbers in a vector, the loop over q is vectorized;
+	in the first stage, where s is 1, the loop over pp is vectorized instead.
+
+	The layout of the twiddles, which are computed by NUMFourierTable_create, is:
+		for every stage: w^k for 1 <= k < p (outer) and 0 <= pp < n/p (inner);
+		moreover, for a general butterfly: cos and sin of 2 pi j / p for 0 <= j < p;
+		and at the end: exp (-2 pi i k / n) for 0 <= k <= n/4, for combining real data of size n
+		(which is 2 m, except for Bluestein's algorithm).
+*/
+
+typedef double VectorOfDoubles __attribute__ ((vector_size (FFT_VECTOR_BYTES)));
+typedef float VectorOfFloats __attribute__ ((vector_size (FFT_VECTOR_BYTES)));
+
+template <typename T> struct VectorOf;
+template <> struct VectorOf <double> { using type = VectorOfDoubles; };
+template <> struct VectorOf <float> { using type = VectorOfFloats; };
+
+template <int numberOfReals> struct ComplexShuffles;
+template <> struct ComplexShuffles <2> {
+	template <typename V> static V swapParts (V x) { return __builtin_shufflevector (x, x, 1, 0); }
+	template <typename V> static V duplicateRealParts (V x) { return __builtin_shufflevector (x, x, 0, 0); }
+	template <typename V> static V duplicateImaginaryParts (V x) { return __builtin_shufflevector (x, x, 1, 1); }
+};
+template <> struct ComplexShuffles <4> {
+	template <typename V> static V swapParts (V x) { return __builtin_shufflevector (x, x, 1, 0, 3, 2); }
+	template <typename V> static V duplicateRealParts (V x) { return __builtin_shufflevector (x, x, 0, 0, 2, 2); }
+	template <typename V> static V duplicateImaginaryParts (V x) { return __builtin_shufflevector (x, x, 1, 1, 3, 3); }
+};
+template <> struct ComplexShuffles <8> {
+	template <typename V> static V swapParts (V x) { return __builtin_shufflevector (x, x, 1, 0, 3, 2, 5, 4, 7, 6); }
+	template <typename V> static V duplicateRealParts (V x) { return __builtin_shufflevector (x, x, 0, 0, 2, 2, 4, 4, 6, 6); }
+	template <typename V> static V duplicateImaginaryParts (V x) { return __builtin_shufflevector (x, x, 1, 1, 3, 3, 5, 5, 7, 7); }
+};
+
+/*
+	A vector of complex numbers.
+*/
+template <typename T>
+struct ComplexPack {
+	using V = typename VectorOf <T>::type;
+	using Shuffles = ComplexShuffles <FFT_VECTOR_BYTES / sizeof (T)>;
+	static constexpr integer numberOfReals = FFT_VECTOR_BYTES / sizeof (T);
+	static constexpr integer numberOfComplexes = numberOfReals / 2;
+	V v;
+
+	static ComplexPack load (const T *p) {
+		ComplexPack result;
+		memcpy (& result.v, p, sizeof (V));
+		return result;
+	}
+	void store (T *p) const {
+		memcpy (p, & v, sizeof (V));
+	}
+	void storeOne (T *p, integer i) const {
+		memcpy (p, (const T *) & v + 2 * i, 2 * sizeof (T));
+	}
+	static ComplexPack loadTwiddles (const double *p) {   // one twiddle per complex number
+		ComplexPack result;
+		for (integer i = 0; i < numberOfReals; i ++)
+			result.v [i] = (T) p [i];
+		return result;
+	}
+	static ComplexPack broadcastTwiddle (const double *p) {   // the same twiddle for all complex numbers
+		ComplexPack result;
+		for (integer i = 0; i < numberOfReals; i ++)
+			result.v [i] = (T) p [i & 1];
+		return result;
+	}
+	static V alternatingSigns (T sign) {   // -1, +1, -1, +1... if `sign` is -1
+		V result;
+		for (integer i = 0; i < numberOfReals; i ++)
+			result [i] = ( i & 1 ? - sign : sign );
+		return result;
+	}
+	friend ComplexPack operator+ (ComplexPack a, ComplexPack b) { return { a.v + b.v }; }
+	friend ComplexPack operator- (ComplexPack a, ComplexPack b) { return { a.v - b.v }; }
+	friend ComplexPack operator* (ComplexPack a, T factor) { return { a.v * factor }; }
+	/*
+		(ar + i ai) (wr + i wi) = (ar wr - ai wi) + i (ai wr + ar wi)
+	*/
+	friend ComplexPack times (ComplexPack a, ComplexPack w) {
+		return { a.v * Shuffles::duplicateRealParts (w.v) +
+				Shuffles::swapParts (a.v) * Shuffles::duplicateImaginaryParts (w.v) * alternatingSigns (-1) };
+	}
+	friend ComplexPack timesConjugate (ComplexPack a, ComplexPack w) {
+		return { a.v * Shuffles::duplicateRealParts (w.v) +
+				Shuffles::swapParts (a.v) * Shuffles::duplicateImaginaryParts (w.v) * alternatingSigns (+1) };
+	}
+	/*
+		-i (ar + i ai) = ai - i ar
+	*/
+	friend ComplexPack timesMinusI (ComplexPack a) {
+		return { Shuffles::swapParts (a.v) * alternatingSigns (+1) };
+	}
+	friend ComplexPack timesPlusI (ComplexPack a) {
+		return { Shuffles::swapParts (a.v) * alternatingSigns (-1) };
+	}
+};
+
+/*
+	A single complex number, for the parts of a stage that cannot be vectorized.
+*/
+template <typename T>
+struct ComplexOne {
+	static constexpr integer numberOfComplexes = 1;
+	T re, im;
+	static ComplexOne load (const T *p) { return { p [0], p [1] }; }
+	void store (T *p) const { p [0] = re; p [1] = im; }
+	void storeOne (T *p, integer /* i */) const { store (p); }
+	static ComplexOne loadTwiddles (const double *p) { return { (T) p [0], (T) p [1] }; }
+	static ComplexOne broadcastTwiddle (const double *p) { return { (T) p [0], (T) p [1] }; }
+	friend ComplexOne operator+ (ComplexOne a, ComplexOne b) { return { a.re + b.re, a.im + b.im }; }
+	friend ComplexOne operator- (ComplexOne a, ComplexOne b) { return { a.re - b.re, a.im - b.im }; }
+	friend ComplexOne operator* (ComplexOne a, T factor) { return { a.re * factor, a.im * factor }; }
+	friend ComplexOne times (ComplexOne a, ComplexOne w) { return { a.re * w.re - a.im * w.im, a.im * w.re + a.re * w.im }; }
+	friend ComplexOne timesConjugate (ComplexOne a, ComplexOne w) { return { a.re * w.re + a.im * w.im, a.im * w.re - a.re * w.im }; }
+	friend ComplexOne timesMinusI (ComplexOne a) { return { a.im, - a.re }; }
+	friend ComplexOne timesPlusI (ComplexOne a) { return { - a.im, a.re }; }
+};
+
+/*
+	The butterflies replace a [0..p-1] with their discrete Fourier transform,
+	with exp (-2 pi i r k / p) if `sign` is -1 (forward) and exp (+2 pi i r k / p) if `sign` is +1 (backward).
+*/
+template <int sign, typename C>
+static inline C timesSignI (C a) {   // i.e. times -i (forward) or times +i (backward)
+	if constexpr (sign < 0)
+		return timesMinusI (a);
+	else
+		return timesPlusI (a);
+}
+
+template <typename T, int sign, integer p, typename C>
+static inline void butterfly (C *a, const double * /* generalRoots */, integer /* generalRadix */) {
+	if constexpr (p == 2) {
+		const C a0 = a [0];
+		a [0] = a0 + a [1];
+		a [1] = a0 - a [1];
+	} else if constexpr (p == 3) {
+		constexpr T sin60 = (T) 0.866025403784438646763723170752936183;
+		const C sum = a [1] + a [2];
+		const C difference = timesSignI <sign> (a [1] - a [2]) * sin60;
+		const C middle = a [0] - sum * (T) 0.5;
+		a [0] = a [0] + sum;
+		a [1] = middle + difference;
+		a [2] = middle - difference;
+	} else if constexpr (p == 4) {
+		const C sum02 = a [0] + a [2], difference02 = a [0] - a [2];
+		const C sum13 = a [1] + a [3], difference13 = timesSignI <sign> (a [1] - a [3]);
+		a [0] = sum02 + sum13;
+		a [1] = difference02 + difference13;
+		a [2] = sum02 - sum13;
+		a [3] = difference02 - difference13;
+	} else if constexpr (p == 5) {
+		constexpr T cos72 = (T) 0.309016994374947424102293417182819059, cos144 = (T) -0.809016994374947424102293417182819059;
+		constexpr T sin72 = (T) 0.951056516295153572116439333379382143, sin144 = (T) 0.587785252292473129168705954639072769;
+		const C sum14 = a [1] + a [4], sum23 = a [2] + a [3];
+		const C difference14 = timesSignI <sign> (a [1] - a [4]), difference23 = timesSignI <sign> (a [2] - a [3]);
+		const C real1 = a [0] + sum14 * cos72 + sum23 * cos144;
+		const C real2 = a [0] + sum14 * cos144 + sum23 * cos72;
+		const C imaginary1 = difference14 * sin72 + difference23 * sin144;
+		const C imaginary2 = difference14 * sin144 - difference23 * sin72;
+		a [0] = a [0] + sum14 + sum23;
+		a [1] = real1 + imaginary1;
+		a [4] = real1 - imaginary1;
+		a [2] = real2 + imaginary2;
+		a [3] = real2 - imaginary2;
+	}
+}
+
+/*
+	The general butterfly for an odd radix p, using the symmetry of cosine and sine:
+		b [k] = a [0] + sum_{r=1}^{(p-1)/2} ((a [r] + a [p-r]) cos (2 pi r k / p) -+ i (a [r] - a [p-r]) sin (2 pi r k / p))
+*/
+constexpr integer NUMfft_MAXIMUM_GENERAL_RADIX = 13;
+
+template <typename T, int sign, typename C>
+static inline void generalButterfly (C *a, const double *roots, integer p) {
+	const integer half = (p - 1) / 2;
+	C sums [NUMfft_MAXIMUM_GENERAL_RADIX / 2], differences [NUMfft_MAXIMUM_GENERAL_RADIX / 2];
+	C a0 = a [0], total = a [0];
+	for (integer r = 1; r <= half; r ++) {
+		sums [r - 1] = a [r] + a [p - r];
+		differences [r - 1] = timesSignI <sign> (a [r] - a [p - r]);
+		total = total + sums [r - 1];
+	}
+	for (integer k = 1; k <= half; k ++) {
+		C realPart = a0, imaginaryPart = a0 - a0;
+		for (integer r = 1; r <= half; r ++) {
+			const integer j = (r * k) % p;
+			realPart = realPart + sums [r - 1] * (T) roots [2 * j];
+			imaginaryPart = imaginaryPart + differences [r - 1] * (T) roots [2 * j + 1];
+		}
+		a [k] = realPart + imaginaryPart;
+		a [p - k] = realPart - imaginaryPart;
+	}
+	a [0] = total;
+}
+
+template <typename T, int sign, integer p, typename C>
+static inline void stageBody (integer p_runtime, const double *generalRoots, C *a) {
+	if constexpr (p == 0)
+		generalButterfly <T, sign> (a, generalRoots, p_runtime);
+	else
+		butterfly <T, sign, p> (a, generalRoots, p_runtime);
+}
+
+template <int sign, typename C>
+static inline C twiddled (C b, C w) {
+	if constexpr (sign < 0)
+		return times (b, w);
+	else
+		return timesConjugate (b, w);
+}
+
+/*
+	One stage of the transform; `p` is 0 for the general butterfly, whose radix is then `p_runtime`.
+*/
+template <typename T, int sign, integer p>
+static void transformStage (integer p_runtime, integer n, integer s, const T *x, T *y, const double *twiddles) {
+	using Pack = ComplexPack <T>;
+	using One = ComplexOne <T>;
+	constexpr integer K = Pack::numberOfComplexes;
+	constexpr integer maximumRadix = ( p == 0 ? NUMfft_MAXIMUM_GENERAL_RADIX : p );
+	const integer radix = ( p == 0 ? p_runtime : p );
+	const integer mm = n / radix;
+	const double *generalRoots = twiddles + 2 * (radix - 1) * mm;
+	if (s >= K) {
+		for (integer pp = 0; pp < mm; pp ++) {
+			Pack w [maximumRadix];   // the same for all q
+			for (integer k = 1; k < radix; k ++)
+				w [k] = Pack::broadcastTwiddle (twiddles + 2 * ((k - 1) * mm + pp));
+			integer q = 0;
+			for (; q + K <= s; q += K) {
+				Pack a [maximumRadix];
+				for (integer r = 0; r < radix; r ++)
+					a [r] = Pack::load (x + 2 * (q + s * (pp + r * mm)));
+				stageBody <T, sign, p> (radix, generalRoots, a);
+				a [0]. store (y + 2 * (q + s * (radix * pp)));
+				for (integer k = 1; k < radix; k ++)
+					twiddled <sign> (a [k], w [k]). store (y + 2 * (q + s * (radix * pp + k)));
+			}
+			for (; q < s; q ++) {
+				One a [maximumRadix];
+				for (integer r = 0; r < radix; r ++)
+					a [r] = One::load (x + 2 * (q + s * (pp + r * mm)));
+				stageBody <T, sign, p> (radix, generalRoots, a);
+				a [0]. store (y + 2 * (q + s * (radix * pp)));
+				for (integer k = 1; k < radix; k ++)
+					twiddled <sign> (a [k], One::broadcastTwiddle (twiddles + 2 * ((k - 1) * mm + pp)))
+							. store (y + 2 * (q + s * (radix * pp + k)));
+			}
+		}
+	} else if (s == 1) {
+		/*
+			Vectorize over `pp` instead, so that the twiddles differ between the complex numbers of a vector
+			and the results are stored one complex number at a time.
+		*/
+		integer pp = 0;
+		for (; pp + K <= mm; pp += K) {
+			Pack a [maximumRadix];
+			for (integer r = 0; r < radix; r ++)
+				a [r] = Pack::load (x + 2 * (pp + r * mm));
+			stageBody <T, sign, p> (radix, generalRoots, a);
+			for (integer i = 0; i < K; i ++)
+				a [0]. storeOne (y + 2 * (radix * (pp + i)), i);
+			for (integer k = 1; k < radix; k ++) {
+				const Pack b = twiddled <sign> (a [k], Pack::loadTwiddles (twiddles + 2 * ((k - 1) * mm + pp)));
+				for (integer i = 0; i < K; i ++)
+					b. storeOne (y + 2 * (radix * (pp + i) + k), i);
+			}
+		}
+		for (; pp < mm; pp ++) {
+			One a [maximumRadix];
+			for (integer r = 0; r < radix; r ++)
+				a [r] = One::load (x + 2 * (pp + r * mm));
+			stageBody <T, sign, p> (radix, generalRoots, a);
+			a [0]. store (y + 2 * (radix * pp));
+			for (integer k = 1; k < radix; k ++)
+				twiddled <sign> (a [k], One::loadTwiddles (twiddles + 2 * ((k - 1) * mm + pp)))
+						. store (y + 2 * (radix * pp + k));
+		}
+	} else {
+		for (integer pp = 0; pp < mm; pp ++) {
+			for (integer q = 0; q < s; q ++) {
+				One a [maximumRadix];
+				for (integer r = 0; r < radix; r ++)
+					a [r] = One::load (x + 2 * (q + s * (pp + r * mm)));
+				stageBody <T, sign, p> (radix, generalRoots, a);
+				a [0]. store (y + 2 * (q + s * (radix * pp)));
+				for (integer k = 1; k < radix; k ++)
+					twiddled <sign> (a [k], One::broadcastTwiddle (twiddles + 2 * ((k - 1) * mm + pp)))
+							. store (y + 2 * (q + s * (radix * pp + k)));
+			}
+		}
+	}
+}
+
+/*
+	The complex transform of size m, from `x` via `y` (and back, and so on).
+	Returns the buffer that contains the result.
+*/
+template <typename T, int sign>
+static T *complexTransform (integer m, constINTVEC const& factors, const double *twiddles, T *x, T *y) {
+	integer n = m, s = 1;
+	for (integer ifactor = 1; ifactor <= factors.size; ifactor ++) {
+		const integer p = factors [ifactor];
+		switch (p) {
+			case 2: transformStage <T, sign, 2> (p, n, s, x, y, twiddles); break;
+			case 3: transformStage <T, sign, 3> (p, n, s, x, y, twiddles); break;
+			case 4: transformStage <T, sign, 4> (p, n, s, x, y, twiddles); break;
+			case 5: transformStage <T, sign, 5> (p, n, s, x, y, twiddles); break;
+			default: transformStage <T, sign, 0> (p, n, s, x, y, twiddles);
+		}
+		twiddles += 2 * (p - 1) * (n / p) + ( p > 5 ? 2 * p : 0 );
+		n /= p;
+		s *= p;
+		std::swap (x, y);
+	}
+	return x;
+}
+
+/*
+	The real transform of size 2 m regards the data as m complex numbers z [j] = x [2j] + i x [2j+1],
+	transforms these to Z, and then separates the transforms of the even and odd samples:
+		E [k] = (Z [k] + conj (Z [m-k])) / 2
+		O [k] = -i (Z [k] - conj (Z [m-k])) / 2
+		X [k] = E [k] + W^k O [k],   X [m-k] = conj (E [k] - W^k O [k]),   with W = exp (-2 pi i / (2 m))
+	The result has the layout of FFTPACK: X [0], Re X [1], Im X [1], ..., Re X [m-1], Im X [m-1], X [m].
+*/
+template <typename T>
+static void separateRealTransform (integer m, const double *realTwiddles, const T *z, T *data) {
+	data [0] = z [0] + z [1];
+	data [2 * m - 1] = z [0] - z [1];
+	for (integer k = 1; k <= m / 2; k ++) {
+		const integer mk = m - k;
+		const T ar = z [2 * k], ai = z [2 * k + 1], br = z [2 * mk], bi = - z [2 * mk + 1];
+		const T er = (T) 0.5 * (ar + br), ei = (T) 0.5 * (ai + bi);
+		const T orr = (T) 0.5 * (ai - bi), oi = (T) -0.5 * (ar - br);
+		const T wr = (T) realTwiddles [2 * k], wi = (T) realTwiddles [2 * k + 1];
+		const T tr = wr * orr - wi * oi, ti = wr * oi + wi * orr;
+		data [2 * k - 1] = er + tr;
+		data [2 * k] = ei + ti;
+		if (mk != k) {
+			data [2 * mk - 1] = er - tr;
+			data [2 * mk] = - (ei - ti);
+		}
+	}
+}
+
+/*
+	The inverse of separateRealTransform, times 2:
+		E [k] = X [k] + conj (X [m-k]),   O [k] = (X [k] - conj (X [m-k])) conj (W^k),   Z [k] = E [k] + i O [k]
+	and Z [m-k] = conj (E [k]) + i conj (O [k]).
+*/
+template <typename T>
+static void combineRealTransform (integer m, const double *realTwiddles, const T *data, T *z) {
+	const T x0 = data [0], xm = data [2 * m - 1];
+	z [0] = x0 + xm;
+	z [1] = x0 - xm;
+	for (integer k = 1; k <= m / 2; k ++) {
+		const integer mk = m - k;
+		const T ar = data [2 * k - 1], ai = data [2 * k], br = data [2 * mk - 1], bi = - data [2 * mk];
+		const T er = ar + br, ei = ai + bi;
+		const T dr = ar - br, di = ai - bi;
+		const T wr = (T) realTwiddles [2 * k], wi = (T) realTwiddles [2 * k + 1];
+		const T orr = dr * wr + di * wi, oi = di * wr - dr * wi;   // (dr + i di) (wr - i wi)
+		z [2 * k] = er - oi;
+		z [2 * k + 1] = ei + orr;
+		if (mk != k) {
+			z [2 * mk] = er + oi;
+			z [2 * mk + 1] = - ei + orr;
+		}
+	}
+}
+
+/*
+	`work` must have room for 2 m numbers.
+	If the number of factors is even, the first stage reads from `work`; callers that prepare their data
+	in that case directly in `work` (see firstStageReadsWork) save a copy by setting `inputIsInWork`.
+*/
+inline bool firstStageReadsWork (constINTVEC const& factors) {
+	return factors.size % 2 == 0;
+}
+
+template <typename T>
+static void realForward (integer n, constINTVEC const& factors, const double *twiddles, const double *realTwiddles, T *data, T *work, bool inputIsInWork) {
+	const integer m = n / 2;
+	T *x = data, *y = work;
+	if (firstStageReadsWork (factors)) {   // make sure the result ends up in `work`
+		if (! inputIsInWork)
+			memcpy (work, data, (size_t) n * sizeof (T));
+		std::swap (x, y);
+	}
+	const T *z = complexTransform <T, -1> (m, factors, twiddles, x, y);
+	Melder_assert (z == work);
+	separateRealTransform <T> (m, realTwiddles, z, data);
+}
+
+/*
+	The inverse of realForward, times 2 m.
+*/
+template <typename T>
+static void realBackward (integer n, constINTVEC const& factors, const double *twiddles, const double *realTwiddles, T *data, T *work) {
+	const integer m = n / 2;
+	combineRealTransform <T> (m, realTwiddles, data, work);
+	T *x = work, *y = data;
+	const T *z = complexTransform <T, +1> (m, factors, twiddles, x, y);
+	if (z != data)
+		memcpy (data, z, (size_t) n * sizeof (T));
+}
+
+/*
+	Bluestein's algorithm computes the complex transform of any size L
+	from transforms of a size M >= 2 L - 1 that the mixed-radix transform can handle.
+	With the "chirp" c [j] = exp (-pi i j^2 / L), and with jk = (j^2 + k^2 - (k-j)^2) / 2,
+	the transform becomes a convolution:
+		Z [k] = c [k] sum_j (z [j] c [j]) conj (c [k-j])
+	which we compute as the backward transform of the product of two forward transforms.
+	`chirpSpectrum` is the forward transform of conj (c), wrapped around to M points, divided by M.
+	The L complex numbers in `z` are replaced with their transform; `work` must have room for 4 M numbers.
+*/
+template <typename T>
+static void bluesteinTransform (integer L, integer M, constINTVEC const& factors, const double *twiddles,
+	const double *chirp, const double *chirpSpectrum, T *z, T *work)
+{
+	T *x = work, *y = work + 2 * M;
+	for (integer j = 0; j < L; j ++) {
+		const T cr = (T) chirp [2 * j], ci = (T) chirp [2 * j + 1], zr = z [2 * j], zi = z [2 * j + 1];
+		x [2 * j] = zr * cr - zi * ci;
+		x [2 * j + 1] = zr * ci + zi * cr;
+	}
+	std::fill (x + 2 * L, x + 2 * M, (T) 0.0);
+	T *spectrum = complexTransform <T, -1> (M, factors, twiddles, x, y);
+	for (integer k = 0; k < M; k ++) {
+		const T sr = spectrum [2 * k], si = spectrum [2 * k + 1];
+		const T br = (T) chirpSpectrum [2 * k], bi = (T) chirpSpectrum [2 * k + 1];
+		spectrum [2 * k] = sr * br - si * bi;
+		spectrum [2 * k + 1] = sr * bi + si * br;
+	}
+	const T *convolution = complexTransform <T, +1> (M, factors, twiddles, spectrum, spectrum == x ? y : x);
+	for (integer k = 0; k < L; k ++) {
+		const T cr = (T) chirp [2 * k], ci = (T) chirp [2 * k + 1];
+		const T ar = convolution [2 * k], ai = convolution [2 * k + 1];
+		z [2 * k] = ar * cr - ai * ci;
+		z [2 * k + 1] = ar * ci + ai * cr;
+	}
+}
+
+/*
+	The real transforms of any size n with Bluestein's algorithm:
+	for even n, a complex transform of size n/2 as in realForward;
+	for odd n, a complex transform of size n with zero imaginary parts.
+	`work` must have room for 4 M + 2 n numbers.
+*/
+template <typename T>
+static void realForwardBluestein (integer n, integer M, constINTVEC const& factors, const double *twiddles, const double *realTwiddles,
+	const double *chirp, const double *chirpSpectrum, T *data, T *work)
+{
+	T *z = work + 4 * M;
+	if (n % 2 == 0) {
+		const integer m = n / 2;
+		memcpy (z, data, (size_t) n * sizeof (T));
+		bluesteinTransform <T> (m, M, factors, twiddles, chirp, chirpSpectrum, z, work);
+		separateRealTransform <T> (m, realTwiddles, z, data);
+	} else {
+		for (integer j = 0; j < n; j ++) {
+			z [2 * j] = data [j];
+			z [2 * j + 1] = (T) 0.0;
+		}
+		bluesteinTransform <T> (n, M, factors, twiddles, chirp, chirpSpectrum, z, work);
+		data [0] = z [0];
+		for (integer k = 1; 2 * k < n; k ++) {
+			data [2 * k - 1] = z [2 * k];
+			data [2 * k] = z [2 * k + 1];
+		}
+	}
+}
+
+/*
+	The backward transform is the complex conjugate of the forward transform of the complex conjugate.
+*/
+template <typename T>
+static void realBackwardBluestein (integer n, integer M, constINTVEC const& factors, const double *twiddles, const double *realTwiddles,
+	const double *chirp, const double *chirpSpectrum, T *data, T *work)
+{
+	T *z = work + 4 * M;
+	if (n % 2 == 0) {
+		const integer m = n / 2;
+		combineRealTransform <T> (m, realTwiddles, data, z);
+		for (integer j = 0; j < m; j ++)
+			z [2 * j + 1] = - z [2 * j + 1];
+		bluesteinTransform <T> (m, M, factors, twiddles, chirp, chirpSpectrum, z, work);
+		for (integer j = 0; j < m; j ++) {
+			data [2 * j] = z [2 * j];
+			data [2 * j + 1] = - z [2 * j + 1];
+		}
+	} else {
+		z [0] = data [0];
+		z [1] = (T) 0.0;
+		for (integer k = 1; 2 * k < n; k ++) {
+			const T re = data [2 * k - 1], im = data [2 * k];
+			z [2 * k] = re;
+			z [2 * k + 1] = - im;
+			z [2 * (n - k)] = re;
+			z [2 * (n - k) + 1] = im;
+		}
+		bluesteinTransform <T> (n, M, factors, twiddles, chirp, chirpSpectrum, z, work);
+		for (integer j = 0; j < n; j ++)
+			data [j] = z [2 * j];   // the real part, which is the same for both conjugates
+	}
+}
+
+/*
+	The entry points, which have to be instantiated here, i.e. under the instruction set of this inclusion.
+*/
+static void realForward_double (integer n, constINTVEC const& factors, const double *twiddles, const double *realTwiddles, double *data, double *work, bool inputIsInWork) {
+	realForward <double> (n, factors, twiddles, realTwiddles, data, work, inputIsInWork);
+}
+static void realBackward_double (integer n, constINTVEC const& factors, const double *twiddles, const double *realTwiddles, double *data, double *work) {
+	realBackward <double> (n, factors, twiddles, realTwiddles, data, work);
+}
+static void realForward_float (integer n, constINTVEC const& factors, const double *twiddles, const double *realTwiddles, float *data, float *work, bool inputIsInWork) {
+	realForward <float> (n, factors, twiddles, realTwiddles, data, work, inputIsInWork);
+}
+static void realBackward_float (integer n, constINTVEC const& factors, const double *twiddles, const double *realTwiddles, float *data, float *work) {
+	realBackward <float> (n, factors, twiddles, realTwiddles, data, work);
+}
+static void realForwardBluestein_double (integer n, integer M, constINTVEC const& factors, const double *twiddles, const double *realTwiddles,
+	const double *chirp, const double *chirpSpectrum, double *data, double *work)
+{
+	realForwardBluestein <double> (n, M, factors, twiddles, realTwiddles, chirp, chirpSpectrum, data, work);
+}
+static void realBackwardBluestein_double (integer n, integer M, constINTVEC const& factors, const double *twiddles, const double *realTwiddles,
+	const double *chirp, const double *chirpSpectrum, double *data, double *work)
+{
+	realBackwardBluestein <double> (n, M, factors, twiddles, realTwiddles, chirp, chirpSpectrum, data, work);
+}
+static void realForwardBluestein_float (integer n, integer M, constINTVEC const& factors, const double *twiddles, const double *realTwiddles,
+	const double *chirp, const double *chirpSpectrum, float *data, float *work)
+{
+	realForwardBluestein <float> (n, M, factors, twiddles, realTwiddles, chirp, chirpSpectrum, data, work);
+}
+static void realBackwardBluestein_float (integer n, integer M, constINTVEC const& factors, const double *twiddles, const double *realTwiddles,
+	const double *chirp, const double *chirpSpectrum, float *data, float *work)
+{
+	realBackwardBluestein <float> (n, M, factors, twiddles, realTwiddles, chirp, chirpSpectrum, data, work);
+}
+
+/* End of file NUMfft_stockham.h */
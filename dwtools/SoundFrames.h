@@ -2,7 +2,7 @@
 #define _SoundFrames_h_
 /* SoundFrames.h
  *
- * Copyright (C) 2024-2025 David Weenink
+ * Copyright (C) 2024-2025 David Weenink, 2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -95,7 +95,7 @@ Thing_define (SoundFrameIntoSpectrum, SoundFrames) {
 	autoVEC fourierSamples;					// size = numberOfFourierSamples
 	autoVEC fourierSamples_channel;
 	autoVEC power_channelAveraged;
-	autoNUMFourierTable fourierTable;		// of dimension numberOfFourierSamples;
+	sharedNUMFourierTable fourierTable;		// of dimension numberOfFourierSamples;
 	
 	void init (constSound input, double effectiveAnalysisWidth, double timeStep,
 		kSound_windowShape windowShape, bool subtractChannelMean)
@@ -121,7 +121,7 @@ private:
 		our fourierSamples_channel = raw_VEC (numberOfFourierSamples);
 		our power_channelAveraged = raw_VEC (numberOfFourierSamples);
 		const integer numberOfFrequencies = numberOfFourierSamples / 2 + 1;
-		our fourierTable = NUMFourierTable_create (our numberOfFourierSamples);
+		our fourierTable = NUMFourierTable_getShared (our numberOfFourierSamples);
 		our spectrum = Spectrum_create (0.5 / our frameAsSound -> dx, numberOfFrequencies);
 		our spectrum -> dx = 1.0 / (our frameAsSound -> dx * our numberOfFourierSamples);
 	}
@@ -1,6 +1,6 @@
 /* Sound_and_Spectrogram_extensions.cpp
  *
- * Copyright (C) 1993-2024 David Weenink
+ * Copyright (C) 1993-2024 David Weenink, 2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -43,7 +43,7 @@ autoSound BandFilterSpectrogram_as_Sound (BandFilterSpectrogram me, int to_dB);
 	where erf(x) = 1 - erfc(x) and n is the windowLength in samples.
 	To compare with the rectangular window we need to divide this by the window width (n -1) x 1^2.
 */
-static void _Spectrogram_windowCorrection (Spectrogram me, integer numberOfSamples_window) {
+static double _Spectrogram_windowCorrectionFactor (integer numberOfSamples_window) {
 	double windowFactor = 1.0;
 	if (numberOfSamples_window > 1) {
 		const double e12 = exp (-12);
@@ -54,60 +54,135 @@ static void _Spectrogram_windowCorrection (Spectrogram me, integer numberOfSampl
 		const double p1 = 4 * NUMsqrtpi * NUMsqrt3 * e12 * (1 - NUMerfcc (arg1)) * (numberOfSamples_window + 1);
 		windowFactor =  (p2 - p1 + 24 * (numberOfSamples_window - 1) * e12 * e12) / denum;
 	}
-	my z.get()  /=  windowFactor;
+	return windowFactor;
 }
 
-static autoSpectrum Sound_to_Spectrum_power (Sound me) {
-	try {
-		autoSpectrum thee = Sound_to_Spectrum (me, true);
-		double scale = 2.0 * thy dx / (my xmax - my xmin);
+static void _Spectrogram_windowCorrection (Spectrogram me, integer numberOfSamples_window) {
+	my z.get()  /=  _Spectrogram_windowCorrectionFactor (numberOfSamples_window);
+}
+
+/*
+	The power spectra of the Gaussian-windowed frames of the first channel of a Sound,
+	with the frequency bins at 0 Hz and the Nyquist frequency counting only once.
+	The frames are windowed and transformed a block at a time (with NUMfft_forward_batch),
+	so they are best requested in increasing order.
+	Each thread needs its own SoundFramePowerSpectra (the Fourier table is shared).
+*/
+struct SoundFramePowerSpectra {
+	Sound sound;
+	Sampled frameSampling;
+	double windowDuration;
+	autoSound window;
+	integer numberOfFourierSamples;
+	sharedNUMFourierTable fourierTable;
+	autoMAT fourierSamples;
+	autoINTVEC firstSamples;
+	autoSpectrum powerSpectrum;   // reused for every frame
+	integer firstFrameInBlock = 0, numberOfFramesInBlock = 0;
+	static constexpr integer numberOfFramesPerBlock = 16;
+
+	SoundFramePowerSpectra (Sound me, Sampled frameSampling, double windowDuration) :
+		sound (me), frameSampling (frameSampling), windowDuration (windowDuration)
+	{
+		const double samplingFrequency = 1.0 / my dx;
+		our window = Sound_createGaussian (windowDuration, samplingFrequency);
+		our numberOfFourierSamples = Melder_iroundUpToPowerOfTwo (our window -> nx);   // as in Sound_to_Spectrum (fast)
+		our fourierTable = NUMFourierTable_getShared (our numberOfFourierSamples);
+		our fourierSamples = raw_MAT (numberOfFramesPerBlock, our numberOfFourierSamples);
+		our firstSamples = raw_INTVEC (numberOfFramesPerBlock);
+		our powerSpectrum = Spectrum_create (0.5 / my dx, our numberOfFourierSamples / 2 + 1);
+		our powerSpectrum -> dx = 1.0 / (my dx * our numberOfFourierSamples);
+		our powerSpectrum -> z.row (2)  <<=  0.0;
+	}
+
+	Spectrum getPowerSpectrum (integer iframe) {
+		if (iframe < our firstFrameInBlock || iframe >= our firstFrameInBlock + our numberOfFramesInBlock)
+			computeBlock (iframe);
+		const constVEC data = our fourierSamples.row (iframe - our firstFrameInBlock + 1);
+		const VEC power = our powerSpectrum -> z.row (1);
+		const integer numberOfFrequencies = our powerSpectrum -> nx;
+		const double amplitudeScaling = sound -> dx;
 		/*
 			factor '2' because we combine positive and negative frequencies
-			thy dx : width of frequency bin
-			my xmax - my xmin : duration of sound
+			powerSpectrum -> dx : width of frequency bin
+			windowDuration : duration of the frame
 		*/
-		VEC re = thy z.row (1), im = thy z.row (2);
-		for (integer i = 1; i <= thy nx; i ++) {
-			const double power = scale * (re [i] * re [i] + im [i] * im [i]);
-			re [i] = power;
-			im [i] = 0.0;
-		}
+		const double scale = 2.0 * our powerSpectrum -> dx / windowDuration;
+		auto powerOf = [&] (double re, double im) {
+			re *= amplitudeScaling;
+			im *= amplitudeScaling;
+			return scale * (re * re + im * im);
+		};
+		power [1] = powerOf (data [1], 0.0);
+		for (integer i = 2; i < numberOfFrequencies; i ++)
+			power [i] = powerOf (data [i + i - 2], data [i + i - 1]);
+		if (numberOfFrequencies > 1)
+			power [numberOfFrequencies] = powerOf (data [our numberOfFourierSamples], 0.0);
 		/*
 			Correction of frequency bins at 0 Hz and nyquist: don't count for two.
 		*/
-		re [1] *= 0.5;
-		re [thy nx] *= 0.5;
-		return thee;
-	} catch (MelderError) {
-		Melder_throw (me, U": no Spectrum with spectral power created.");
+		power [1] *= 0.5;
+		power [numberOfFrequencies] *= 0.5;
+		return our powerSpectrum.get();
 	}
-}
 
-static void Sound_into_BarkSpectrogram_frame (Sound me, BarkSpectrogram thee, integer frame) {
-	autoSpectrum him = Sound_to_Spectrum_power (me);
-	integer numberOfFrequencies = his nx;
+private:
+	void computeBlock (integer firstFrame) {
+		our firstFrameInBlock = firstFrame;
+		our numberOfFramesInBlock = std::min (numberOfFramesPerBlock, frameSampling -> nx - firstFrame + 1);
+		for (integer iframe = 1; iframe <= our numberOfFramesInBlock; iframe ++) {
+			const double t = Sampled_indexToX (frameSampling, firstFrame - 1 + iframe);
+			our firstSamples [iframe] = Sampled_xToNearestIndex (sound, t - windowDuration / 2.0);   // as in Sound_into_Sound
+		}
+		NUMfft_forward_batch (our fourierTable.get(),
+			MAT (& our fourierSamples [1] [1], our numberOfFramesInBlock, our numberOfFourierSamples),
+			sound -> z.row (1), our firstSamples.part (1, our numberOfFramesInBlock), our window -> z.row (1), false
+		);
+	}
+};
+
+/*
+	The weights with which a bank of filters combines the bins of a power spectrum,
+	computed once for all frames.
+*/
+struct SpectralFilterBank {
+	autoINTVEC firstBin, lastBin;
+	autoMAT weights;   // weights [ifilter] [ibin]
+
+	SpectralFilterBank (integer numberOfFilters, integer numberOfBins) {
+		our firstBin = raw_INTVEC (numberOfFilters);
+		our lastBin = raw_INTVEC (numberOfFilters);
+		our weights = zero_MAT (numberOfFilters, numberOfBins);
+	}
 
-	autoVEC z = raw_VEC (numberOfFrequencies);
-	for (integer ifreq = 1; ifreq <= numberOfFrequencies; ifreq ++) {
-		const double frequency_Hz = his x1 + (ifreq - 1) * his dx;
-		z [ifreq] = thy v_hertzToFrequency (frequency_Hz);
+	void filter (constVEC const& power, VEC const& filterOutputs) const {
+		for (integer ifilter = 1; ifilter <= filterOutputs.size; ifilter ++) {
+			longdouble sum = 0.0;
+			for (integer ibin = our firstBin [ifilter]; ibin <= our lastBin [ifilter]; ibin ++)
+				sum += our weights [ifilter] [ibin] * power [ibin];
+			filterOutputs [ifilter] = double (sum);
+		}
 	}
+};
 
+static SpectralFilterBank barkFilterBank (Spectrum him, BarkSpectrogram thee) {
+	const integer numberOfFrequencies = his nx;
+	SpectralFilterBank bank (thy ny, numberOfFrequencies);
 	for (integer i = 1; i <= thy ny; i ++) {
 		const double z0 = thy y1 + (i - 1) * thy dy;
-		constVEC pow = his z.row (1); // TODO ??
-		longdouble p = 0.0;
+		bank.firstBin [i] = 1;
+		bank.lastBin [i] = numberOfFrequencies;
 		for (integer ifreq = 1; ifreq <= numberOfFrequencies; ifreq ++) {
 			/*
 				Sekey & Hanson filter is defined in the power domain.
 				We therefore multiply the power with a (and not a^2).
 				integral (F(z),z=0..25) = 1.58/9
 			*/
-			const double a = NUMsekeyhansonfilter_amplitude (z0, z [ifreq]);
-			p += a * pow [ifreq] ;
+			const double frequency_Hz = his x1 + (ifreq - 1) * his dx;
+			bank.weights [i] [ifreq] = NUMsekeyhansonfilter_amplitude (z0, thy v_hertzToFrequency (frequency_Hz));
 		}
-		thy z [i] [frame] = double (p);
 	}
+	return bank;
 }
 
 autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, double dt, double f1_bark, double fmax_bark, double df_bark) {
@@ -134,25 +209,27 @@ autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, do
 		integer numberOfFrames;
 		double t1;
 		Sampled_shortTermAnalysis (me, windowDuration, dt, & numberOfFrames, & t1);
-		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
-		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
 		autoBarkSpectrogram thee = BarkSpectrogram_create (my xmin, my xmax, numberOfFrames, dt, t1, fmin_bark, fmax_bark, numberOfFilters, df_bark, f1_bark);
+		SoundFramePowerSpectra frames (me, thee.get(), windowDuration);
+		const SpectralFilterBank bank = barkFilterBank (frames.powerSpectrum.get(), thee.get());
 
 		autoMelderProgress progess (U"Sound to BarkSpectrogram...");
 
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const double t = Sampled_indexToX (thee.get(), iframe);
+		MelderThread_PARALLEL (numberOfFrames, 8) {
+			SoundFramePowerSpectra threadFrames (me, thee.get(), windowDuration);
+			autoVEC filterOutputs = raw_VEC (numberOfFilters);
+			MelderThread_FOR (iframe) {
+				bank.filter (threadFrames.getPowerSpectrum (iframe) -> z.row (1), filterOutputs.get());
+				thy z.column (iframe)  <<=  filterOutputs.get();
+				if (MelderThread_IS_MASTER) {   // then we can interact with the GUI
+					const double estimatedProgress = MelderThread_ESTIMATED_PROGRESS;
+					Melder_progress (estimatedProgress, U"BarkSpectrogram analysis: frame ",
+						Melder_iround (numberOfFrames * estimatedProgress), U" from ", numberOfFrames, U".");
+				}
+			}
+		} MelderThread_ENDPARALLEL
 
-			Sound_into_Sound (me, sframe.get(), t - windowDuration / 2.0);
-			Sounds_multiply (sframe.get(), window.get());
-			Sound_into_BarkSpectrogram_frame (sframe.get(), thee.get(), iframe);
-
-			if (iframe % 10 == 1)
-				Melder_progress ( (double) iframe / numberOfFrames,  U"BarkSpectrogram analysis: frame ",
-					iframe, U" from ", numberOfFrames, U".");
-		}
-		
-		_Spectrogram_windowCorrection ((Spectrogram) thee.get(), window -> nx);
+		_Spectrogram_windowCorrection ((Spectrogram) thee.get(), frames.window -> nx);
 
 		return thee;
 	} catch (MelderError) {
@@ -160,74 +237,90 @@ autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, do
 	}
 }
 
-static void Sound_into_MelSpectrogram_frame (Sound me, MelSpectrogram thee, integer frame) {
-	autoSpectrum him = Sound_to_Spectrum_power (me);
-
+static SpectralFilterBank melFilterBank (Spectrum him, MelSpectrogram thee) {
+	SpectralFilterBank bank (thy ny, his nx);
 	for (integer ifilter = 1; ifilter <= thy ny; ifilter ++) {
-		longdouble power = 0.0;
 		const double fc_mel = thy y1 + (ifilter - 1) * thy dy;
 		const double fc_hz = thy v_frequencyToHertz (fc_mel);
 		const double fl_hz = thy v_frequencyToHertz (std::max (fc_mel - thy dy, 0.0));
 		const double fh_hz =  thy v_frequencyToHertz (std::min (fc_mel + thy dy, his xmax));
 		integer ifrom, ito;
-		Sampled_getWindowSamples (him.get(), fl_hz, fh_hz, & ifrom, & ito);
+		Sampled_getWindowSamples (him, fl_hz, fh_hz, & ifrom, & ito);
+		bank.firstBin [ifilter] = ifrom;
+		bank.lastBin [ifilter] = ito;
 		for (integer i = ifrom; i <= ito; i ++) {
 			/*
 				Bin with a triangular filter the power (= amplitude-squared)
 			*/
 			const double f = his x1 + (i - 1) * his dx;
-			const double a = NUMtriangularfilter_amplitude (fl_hz, fc_hz, fh_hz, f);
-			power += a * his z [1] [i];
+			bank.weights [ifilter] [i] = NUMtriangularfilter_amplitude (fl_hz, fc_hz, fh_hz, f);
 		}
-		thy z [ifilter] [frame] = double (power);
 	}
+	return bank;
 }
 
-autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, double dt, double f1_mel, double fmax_mel, double df_mel) {
-	try {
-		const double samplingFrequency = 1.0 / my dx, nyquist = 0.5 * samplingFrequency;
-		const double windowDuration = 2.0 * analysisWidth;   // Gaussian window
-		double fmin_mel = 0.0;
-		const double fbottom = NUMhertzToMel2 (100.0), fceiling = NUMhertzToMel2 (nyquist);
-
-		// Check defaults.
-
-		if (fmax_mel <= 0.0 || fmax_mel > fceiling)
-			fmax_mel = fceiling;
-		if (fmax_mel <= f1_mel) {
-			f1_mel = fbottom;
-			fmax_mel = fceiling;
-		}
-		if (f1_mel <= 0.0)
-			f1_mel = fbottom;
-		if (df_mel <= 0.0)
-			df_mel = 100.0;
+/*
+	Determine the mel filters and frames of a Sound_to_MelSpectrogram analysis
+	and create an empty MelSpectrogram with a single frame,
+	which only serves to describe the frequency axis.
+*/
+static autoMelSpectrogram Sound_to_MelSpectrogram_getSettings (Sound me, double analysisWidth, double dt, double f1_mel, double fmax_mel, double df_mel,
+	integer *out_numberOfFrames, double *out_t1)
+{
+	const double samplingFrequency = 1.0 / my dx, nyquist = 0.5 * samplingFrequency;
+	const double windowDuration = 2.0 * analysisWidth;   // Gaussian window
+	double fmin_mel = 0.0;
+	const double fbottom = NUMhertzToMel2 (100.0), fceiling = NUMhertzToMel2 (nyquist);
+
+	// Check defaults.
+
+	if (fmax_mel <= 0.0 || fmax_mel > fceiling)
+		fmax_mel = fceiling;
+	if (fmax_mel <= f1_mel) {
+		f1_mel = fbottom;
+		fmax_mel = fceiling;
+	}
+	if (f1_mel <= 0.0)
+		f1_mel = fbottom;
+	if (df_mel <= 0.0)
+		df_mel = 100.0;
 
-		// Determine the number of filters.
+	// Determine the number of filters.
 
-		const integer numberOfFilters = Melder_iround ((fmax_mel - f1_mel) / df_mel);
+	const integer numberOfFilters = Melder_iround ((fmax_mel - f1_mel) / df_mel);
 
+	Sampled_shortTermAnalysis (me, windowDuration, dt, out_numberOfFrames, out_t1);
+	return MelSpectrogram_create (my xmin, my xmax, 1, dt, *out_t1, fmin_mel, fmax_mel, numberOfFilters, df_mel, f1_mel);
+}
 
+autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, double dt, double f1_mel, double fmax_mel, double df_mel) {
+	try {
+		const double windowDuration = 2.0 * analysisWidth;   // Gaussian window
 		integer numberOfFrames;
 		double t1;
-		Sampled_shortTermAnalysis (me, windowDuration, dt, & numberOfFrames, & t1);
-		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
-		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
-		autoMelSpectrogram thee = MelSpectrogram_create (my xmin, my xmax, numberOfFrames, dt, t1, fmin_mel, fmax_mel, numberOfFilters, df_mel, f1_mel);
+		autoMelSpectrogram settings = Sound_to_MelSpectrogram_getSettings (me, analysisWidth, dt, f1_mel, fmax_mel, df_mel, & numberOfFrames, & t1);
+		autoMelSpectrogram thee = MelSpectrogram_create (my xmin, my xmax, numberOfFrames, dt, t1,
+				settings -> ymin, settings -> ymax, settings -> ny, settings -> dy, settings -> y1);
+		SoundFramePowerSpectra frames (me, thee.get(), windowDuration);
+		const SpectralFilterBank bank = melFilterBank (frames.powerSpectrum.get(), thee.get());
 
 		autoMelderProgress progress (U"Sound to MelSpectrogram...");
 
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const double t = Sampled_indexToX (thee.get(), iframe);
-			Sound_into_Sound (me, sframe.get(), t - windowDuration / 2.0);
-			Sounds_multiply (sframe.get(), window.get());
-			Sound_into_MelSpectrogram_frame (sframe.get(), thee.get(), iframe);
-			
-			if (iframe % 10 == 1)
-				Melder_progress ((double) iframe / numberOfFrames, U"Frame ", iframe, U" out of ", numberOfFrames, U".");
-		}
+		MelderThread_PARALLEL (numberOfFrames, 8) {
+			SoundFramePowerSpectra threadFrames (me, thee.get(), windowDuration);
+			autoVEC filterOutputs = raw_VEC (thy ny);
+			MelderThread_FOR (iframe) {
+				bank.filter (threadFrames.getPowerSpectrum (iframe) -> z.row (1), filterOutputs.get());
+				thy z.column (iframe)  <<=  filterOutputs.get();
+				if (MelderThread_IS_MASTER) {   // then we can interact with the GUI
+					const double estimatedProgress = MelderThread_ESTIMATED_PROGRESS;
+					Melder_progress (estimatedProgress, U"Frame ",
+						Melder_iround (numberOfFrames * estimatedProgress), U" out of ", numberOfFrames, U".");
+				}
+			}
+		} MelderThread_ENDPARALLEL
 		
-		_Spectrogram_windowCorrection ((Spectrogram) thee.get(), window -> nx);
+		_Spectrogram_windowCorrection ((Spectrogram) thee.get(), frames.window -> nx);
 
 		return thee;
 	} catch (MelderError) {
@@ -235,13 +328,64 @@ autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, doub
 	}
 }
 
+autoMFCC Sound_to_MFCC_direct (Sound me, integer numberOfCoefficients, double analysisWidth, double dt, double f1_mel, double fmax_mel, double df_mel) {
+	try {
+		const double windowDuration = 2.0 * analysisWidth;   // Gaussian window
+		integer numberOfFrames;
+		double t1;
+		autoMelSpectrogram settings = Sound_to_MelSpectrogram_getSettings (me, analysisWidth, dt, f1_mel, fmax_mel, df_mel, & numberOfFrames, & t1);
+		const integer numberOfFilters = settings -> ny;
+		Melder_require (numberOfFilters > 1,
+			U"There should be at least two mel filters.");
+		if (numberOfCoefficients <= 0 || numberOfCoefficients > numberOfFilters - 1)
+			numberOfCoefficients = numberOfFilters - 1;
+		autoMFCC thee = MFCC_create (my xmin, my xmax, numberOfFrames, dt, t1, numberOfFilters - 1, settings -> ymin, settings -> ymax);
+		SoundFramePowerSpectra frames (me, thee.get(), windowDuration);
+		const SpectralFilterBank bank = melFilterBank (frames.powerSpectrum.get(), settings.get());
+		const double windowFactor = _Spectrogram_windowCorrectionFactor (frames.window -> nx);
+		autoMAT cosinesTable = MATcosinesTable (numberOfFilters);
+
+		autoMelderProgress progress (U"Sound to MFCC...");
+
+		MelderThread_PARALLEL (numberOfFrames, 8) {
+			SoundFramePowerSpectra threadFrames (me, thee.get(), windowDuration);
+			autoVEC filterOutputs = raw_VEC (numberOfFilters);
+			autoVEC cepstrum = raw_VEC (numberOfFilters);
+			MelderThread_FOR (iframe) {
+				bank.filter (threadFrames.getPowerSpectrum (iframe) -> z.row (1), filterOutputs.get());
+				/*
+					The same as Sound_to_MelSpectrogram followed by MelSpectrogram_to_MFCC.
+				*/
+				for (integer ifilter = 1; ifilter <= numberOfFilters; ifilter ++) {
+					const double power = filterOutputs [ifilter] / windowFactor;
+					filterOutputs [ifilter] = ( power > 0.0 ? 10.0 * log10 (power / BandFilterSpectrogram_DBREF) : -300.0 );
+				}
+				VECcosineTransform_preallocated (cepstrum.get(), filterOutputs.get(), cosinesTable.get());
+				const CC_Frame ccframe = & thy frame [iframe];
+				CC_Frame_init (ccframe, numberOfCoefficients);
+				for (integer i = 1; i <= numberOfCoefficients; i ++)
+					ccframe -> c [i] = cepstrum [i + 1];
+				ccframe -> c0 = cepstrum [1];
+				if (MelderThread_IS_MASTER) {   // then we can interact with the GUI
+					const double estimatedProgress = MelderThread_ESTIMATED_PROGRESS;
+					Melder_progress (estimatedProgress, U"Frame ",
+						Melder_iround (numberOfFrames * estimatedProgress), U" out of ", numberOfFrames, U".");
+				}
+			}
+		} MelderThread_ENDPARALLEL
+
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": no MFCC created.");
+	}
+}
+
 /*
 	Analog formant filter response :
 	H(f) = i f B / (f1^2 - f^2 + i f B)
 */
-static int Sound_into_Spectrogram_frame (Sound me, Spectrogram thee, integer frame, double bw) {
+static int Spectrum_into_Spectrogram_frame (Spectrum him, Spectrogram thee, integer frame, double bw) {
 	Melder_assert (bw > 0.0);
-	autoSpectrum him = Sound_to_Spectrum_power (me);
 
 	for (integer ifilter = 1; ifilter <= thy ny; ifilter ++) {
 		const double fc = thy y1 + (ifilter - 1) * thy dy;
@@ -302,35 +446,32 @@ autoSpectrogram Sound_Pitch_to_Spectrogram (Sound me, Pitch thee, double analysi
 		const integer numberOfFilters = Melder_iround ( (fmax_hz - f1_hz) / df_hz);
 
 		double t1;
-		integer numberOfFrames, numberOfUndefinedPitchFrames = 0;
+		integer numberOfFrames;
 		Sampled_shortTermAnalysis (me, windowDuration, dt, & numberOfFrames, & t1);
 		autoSpectrogram him = Spectrogram_create (my xmin, my xmax, numberOfFrames, dt, t1, fmin_hz, fmax_hz, numberOfFilters, df_hz, f1_hz);
 
 		// Temporary objects
 
-		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
-		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
+		SoundFramePowerSpectra frames (me, him.get(), windowDuration);
 		autoMelderProgress progress (U"Sound & Pitch: To Spectrogram...");
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const double t = Sampled_indexToX (him.get(), iframe);
-			double f0 = Pitch_getValueAtTime (thee, t, kPitch_unit::HERTZ, 0);
-
-			if (isundef (f0) || f0 == 0.0) {
-				numberOfUndefinedPitchFrames ++;
-				f0 = f0_median;
+		MelderThread_PARALLEL (numberOfFrames, 8) {
+			SoundFramePowerSpectra threadFrames (me, him.get(), windowDuration);
+			MelderThread_FOR (iframe) {
+				const double t = Sampled_indexToX (him.get(), iframe);
+				double f0 = Pitch_getValueAtTime (thee, t, kPitch_unit::HERTZ, 0);
+				if (isundef (f0) || f0 == 0.0)
+					f0 = f0_median;
+				const double b = relative_bw * f0;
+				Spectrum_into_Spectrogram_frame (threadFrames.getPowerSpectrum (iframe), him.get(), iframe, b);
+				if (MelderThread_IS_MASTER) {   // then we can interact with the GUI
+					const double estimatedProgress = MelderThread_ESTIMATED_PROGRESS;
+					Melder_progress (estimatedProgress, U"Frame ",
+						Melder_iround (numberOfFrames * estimatedProgress), U" out of ", numberOfFrames, U".");
+				}
 			}
-			const double b = relative_bw * f0;
-			Sound_into_Sound (me, sframe.get(), t - windowDuration / 2.0);
-			Sounds_multiply (sframe.get(), window.get());
-
-			Sound_into_Spectrogram_frame (sframe.get(), him.get(), iframe, b);
-
-			if (iframe % 10 == 1)
-				Melder_progress ((double) iframe / numberOfFrames, U"Frame ", iframe, U" out of ",
-					numberOfFrames, U".");
-		}
+		} MelderThread_ENDPARALLEL
 		
-		_Spectrogram_windowCorrection (him.get(), window -> nx);
+		_Spectrogram_windowCorrection (him.get(), frames.window -> nx);
 
 		return him;
 	} catch (MelderError) {
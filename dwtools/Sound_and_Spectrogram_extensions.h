@@ -2,7 +2,7 @@
 #define _Sound_and_Spectrogram_extensions_h_
 /* Sound_and_Spectrogram_extensions.h
  *
- * Copyright (C) 2014-2015,2023 David Weenink
+ * Copyright (C) 2014-2015,2023 David Weenink, 2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -40,6 +40,13 @@ autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, do
 autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, double dt,
 	double f1_mel, double fmax_mel, double df_mel);
 
+autoMFCC Sound_to_MFCC_direct (Sound me, integer numberOfCoefficients, double analysisWidth, double dt,
+	double f1_mel, double fmax_mel, double df_mel);
+/*
+	The same as Sound_to_MelSpectrogram followed by MelSpectrogram_to_MFCC,
+	but frame by frame, without creating the intermediate MelSpectrogram.
+*/
+
 autoSpectrogram Sound_to_Spectrogram_pitchDependent (Sound me, double analysisWidth,
 	double dt, double f1_hz, double fmax_hz, double df_hz, double relative_bw,
 	double pitchFloor, double pitchCeiling);
@@ -1,6 +1,6 @@
 /* Sound_to_MFCC.cpp
  *
- * Copyright (C) 1993-2017 David Weenink
+ * Copyright (C) 1993-2017 David Weenink, 2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,19 +19,14 @@
 /*
  djmw 20010410
  djmw 20020813 GPL header
+ pb 20261018 without an intermediate MelSpectrogram
 */
 
 #include "Sound_to_MFCC.h"
 #include "Sound_and_Spectrogram_extensions.h"
 
 autoMFCC Sound_to_MFCC (Sound me, integer numberOfCoefficients, double analysisWidth, double dt, double f1_mel, double fmax_mel, double df_mel) {
-	try {
-		autoMelSpectrogram mf = Sound_to_MelSpectrogram (me, analysisWidth, dt, f1_mel, fmax_mel, df_mel);
-		autoMFCC mfcc = MelSpectrogram_to_MFCC (mf.get(), numberOfCoefficients);
-		return mfcc;
-	} catch (MelderError) {
-		Melder_throw (me, U": no MFCC created.");
-	}
+	return Sound_to_MFCC_direct (me, numberOfCoefficients, analysisWidth, dt, f1_mel, fmax_mel, df_mel);
 }
 
 /* End of file Sound_to_MFCC.cpp */
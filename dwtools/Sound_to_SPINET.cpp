@@ -1,6 +1,6 @@
 /* Sound_to_SPINET.cpp
  *
- * Copyright (C) 1993-2019 David Weenink
+ * Copyright (C) 1993-2019 David Weenink, 2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,6 +19,7 @@
 /*
  djmw 20020813 GPL header
  djmw 20070103 Sound interface changes
+ pb 20261018 multithreaded filter bank; precomputed interaction weights
 */
 
 #include "Sound_to_SPINET.h"
@@ -51,11 +52,10 @@ autoSPINET Sound_to_SPINET (Sound me, double timeStep, double windowDuration, do
 		Sampled_shortTermAnalysis (me, windowDuration, timeStep, & numberOfFrames, & firstTime);
 		autoSPINET thee = SPINET_create (my xmin, my xmax, numberOfFrames, timeStep, firstTime, minimumFrequencyHz, maximumFrequencyHz, numberOfGammaFilters, excitationErbProportion, inhibitionErbProportion);
 		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
-		autoSound frame = Sound_createSimple (1, windowDuration, samplingFrequency);
 		autoVEC f = raw_VEC (numberOfGammaFilters);
 		autoVEC bw = raw_VEC (numberOfGammaFilters);
-		autoVEC aex = raw_VEC (numberOfGammaFilters);
-		autoVEC ain = raw_VEC (numberOfGammaFilters);
+		autoVEC aex = zero_VEC (numberOfGammaFilters);
+		autoVEC ain = zero_VEC (numberOfGammaFilters);
 		/*
 			Cochlear filterbank: gammatone.
 		*/
@@ -66,48 +66,67 @@ autoSPINET Sound_to_SPINET (Sound me, double timeStep, double windowDuration, do
 
 		autoMelderProgress progress (U"Sound to SPINET...");
 
-		for (integer i = 1; i <= numberOfGammaFilters; i ++) {
-			const double bb = (f [i] / 1000.0) * exp (- f [i] / 1000.0); // outer & middle ear and phase locking
-			const double tgammaMax = (thy gamma - 1) / bw [i]; // the time where the gamma function envelope has its maximum
-			const double gammaMaxAmplitude = pow ((thy gamma - 1) / (NUMe * bw [i]), thy gamma - 1);
-			const double timeCorrection = tgammaMax - windowDuration / 2.0;
+		/*
+			The filters are independent of each other, so each thread can handle its own filters,
+			with its own frame buffer.
+		*/
+		MelderThread_PARALLEL (numberOfGammaFilters, 4) {
+			autoSound frame = Sound_createSimple (1, windowDuration, samplingFrequency);
+			MelderThread_FOR (i) {
+				const double bb = (f [i] / 1000.0) * exp (- f [i] / 1000.0); // outer & middle ear and phase locking
+				const double tgammaMax = (thy gamma - 1) / bw [i]; // the time where the gamma function envelope has its maximum
+				const double gammaMaxAmplitude = pow ((thy gamma - 1) / (NUMe * bw [i]), thy gamma - 1);
+				const double timeCorrection = tgammaMax - windowDuration / 2.0;
 
-			autoSound gammaTone = Sound_createGammaTone (0.0, 0.1, samplingFrequency, thy gamma, b, f [i], 0.0, 0.0, false);
-			autoSound filtered = Sounds_convolve (me, gammaTone.get(), kSounds_convolve_scaling::SUM, kSounds_convolve_signalOutsideTimeDomain::ZERO);
-			/*
-				To energy measure: weigh with broad-band transfer function.
-			*/
-			for (integer j = 1; j <= numberOfFrames; j ++) {
-				Sound_into_Sound (filtered.get(), frame.get(), Sampled_indexToX (thee.get(), j) + timeCorrection);
-				Sounds_multiply (frame.get(), window.get());
-				thy y [i] [j] = Sound_power (frame.get()) * bb / gammaMaxAmplitude;
+				autoSound gammaTone = Sound_createGammaTone (0.0, 0.1, samplingFrequency, thy gamma, b, f [i], 0.0, 0.0, false);
+				autoSound filtered = Sounds_convolve (me, gammaTone.get(), kSounds_convolve_scaling::SUM, kSounds_convolve_signalOutsideTimeDomain::ZERO);
+				/*
+					To energy measure: weigh with broad-band transfer function.
+				*/
+				for (integer j = 1; j <= numberOfFrames; j ++) {
+					Sound_into_Sound (filtered.get(), frame.get(), Sampled_indexToX (thee.get(), j) + timeCorrection);
+					Sounds_multiply (frame.get(), window.get());
+					thy y [i] [j] = Sound_power (frame.get()) * bb / gammaMaxAmplitude;
+				}
+				if (MelderThread_IS_MASTER) {
+					const double estimatedProgress = MelderThread_ESTIMATED_PROGRESS;
+					Melder_progress (0.9 * estimatedProgress, U"SPINET: analysed approximately ",
+						Melder_iround (numberOfGammaFilters * estimatedProgress), U" out of ", numberOfGammaFilters, U" filters.");
+				}
 			}
-			Melder_progress ((double) i / numberOfGammaFilters, U"SPINET: filter ", i, U" from ", numberOfGammaFilters, U".");
-		}
+		} MelderThread_ENDPARALLEL
 		/*
 			Excitatory and inhibitory area functions.
 		*/
+		autoMAT hex = raw_MAT (numberOfGammaFilters, numberOfGammaFilters);
+		autoMAT hin = raw_MAT (numberOfGammaFilters, numberOfGammaFilters);
 		for (integer i = 1; i <= numberOfGammaFilters; i ++) {
 			for (integer k = 1; k <= numberOfGammaFilters; k ++) {
 				const double fr = (f [k] - f [i]) / bw [i];
-				aex [i] += fgamma (fr / thy excitationErbProportion, thy gamma);
-				ain [i] += fgamma (fr / thy inhibitionErbProportion, thy gamma);
+				hex [i] [k] = fgamma (fr / thy excitationErbProportion, thy gamma);
+				hin [i] [k] = fgamma (fr / thy inhibitionErbProportion, thy gamma);
+				aex [i] += hex [i] [k];
+				ain [i] += hin [i] [k];
 			}
 		}
 		/*
-			On-center off-surround interactions
+			On-center off-surround interactions.
+			The weights do not depend on time, so the interactions of all frames together
+			form a single matrix multiplication, whose rows (filters) can be computed in parallel.
 		*/
-		for (integer j = 1; j <= numberOfFrames; j ++)
-			for (integer i = 1; i <= numberOfGammaFilters; i ++) {
-				longdouble a = 0.0;
-				for (integer k = 1; k <= numberOfGammaFilters; k ++) {
-					const double fr = (f [k] - f [i]) / bw [i];
-					const double hexsq = fgamma (fr / thy excitationErbProportion, thy gamma);
-					const double hinsq = fgamma (fr / thy inhibitionErbProportion, thy gamma);
-					a += thy y [k] [j] * (hexsq / aex [i] - hinsq / ain [i]);
-				}
-				thy s [i] [j] = a > 0.0 ? (double) a : 0.0;
+		autoMAT weights = raw_MAT (numberOfGammaFilters, numberOfGammaFilters);
+		for (integer i = 1; i <= numberOfGammaFilters; i ++)
+			for (integer k = 1; k <= numberOfGammaFilters; k ++)
+				weights [i] [k] = hex [i] [k] / aex [i] - hin [i] [k] / ain [i];
+		MelderThread_PARALLEL (numberOfGammaFilters, 4) {
+			MelderThread_FOR (i) {
+				const MATVU interaction = thy s.horizontalBand (i, i);
+				mul_fast_MAT_out (interaction, weights.horizontalBand (i, i), thy y.get());
+				for (integer j = 1; j <= numberOfFrames; j ++)
+					if (interaction [1] [j] < 0.0)
+						interaction [1] [j] = 0.0;
 			}
+		} MelderThread_ENDPARALLEL
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U":  no SPINET created.");
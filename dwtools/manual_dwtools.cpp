@@ -165,10 +165,8 @@ static void Electroglottogram_drawStylizedLevels (Graphics g) {
 }
 
 static void drawSpectra (Graphics g) {
-	static Spectrum dft = nullptr;
 	autoSound sound = Sound_createAsPureTone (1, 0.0, 3.9799, 10000.0, 3333.0, 1.0, 0.0, 0.0);
-	if (! dft)
-		dft = Sound_to_Spectrum (sound.get(), false).releaseToAmbiguousOwner();
+	autoSpectrum dft = Sound_to_Spectrum (sound.get(), false);
 	autoSpectrum fft = Sound_to_Spectrum (sound.get(), true);
 	autoSpectrum ups = Sound_to_Spectrum_resampled (sound.get(), 30);
 	const double fmin = 0.0, fmax = 5000.0, dbmin = -30.0, dbmax = 110.0;
@@ -178,7 +176,7 @@ static void drawSpectra (Graphics g) {
 	Graphics_setColour (g, Melder_SILVER);
 	Spectrum_draw (fft.get(), g, fmin, fmax, dbmin, dbmax, true);
 	Graphics_setColour (g, Melder_BLACK);
-	Spectrum_draw (dft, g, fmin, fmax, dbmin, dbmax, false);
+	Spectrum_draw (dft.get(), g, fmin, fmax, dbmin, dbmax, false);
 	Graphics_setColour (g, Melder_RED);
 	Spectrum_draw (ups.get(), g, fmin, fmax, dbmin, dbmax, false);
 	Graphics_setColour (g, Melder_BLACK);
@@ -4662,7 +4660,7 @@ INTRO (U"A command that creates a @Sound from the selected @Spectrum by using a
 NORMAL (U"For more details see @@Sound: To Spectrum (resampled)...@.")
 MAN_END
 
-MAN_BEGIN (U"Sound: To Spectrum (resampled)...", U"djmw", 20220105)
+MAN_BEGIN (U"Sound: To Spectrum (resampled)...", U"djmw", 20261018)
 INTRO (U"A command that creates a @Spectrum from the selected @Sound by using a fast approximation of the Discrete Fourier Transform (DFT).")
 NORMAL (U"In general the amount of computation necessary to calculate the spectrum of a sound that consists "
 	"of %N samples, is of the order of %O(%N log %N) multiplications. If the number of samples happens to be an "
@@ -4696,11 +4694,13 @@ CODE (U"time_resampled = stopwatch")
 CODE (U"selectObject: sound")
 CODE (U"spectrum_fft = To Spectrum: \"yes\"")
 CODE (U"time_fft = stopwatch")
-NORMAL (U"On my computer from 2019 the calculation of `spectrum_dft` happens to be very slow because of its naive %O(%N^2) algorithm. "
-	"It takes 2.258 s while the resampled approximation only takes 0.031s and the approximation by adding zero values takes "
+NORMAL (U"On my computer from 2019 the calculation of `spectrum_dft` used to be very slow because of its naive %O(%N^2) algorithm. "
+	"It took 2.258 s while the resampled approximation only took 0.031s and the approximation by adding zero values took "
 	"approximately 0.003 s. If the duration of the sound had been 10.0069 s, the number of samples again would be a prime number and "
-	"the computing times are 14.127 s, 0.059 s and 0.005 s, respectively. This again shows that the naive implementation is "
-	"very slow compared to the other two. It is also clear that resampling takes some extra time as compared to adding zero sample values. ")
+	"the computing times were 14.127 s, 0.059 s and 0.005 s, respectively. "
+	"Since October 2026, however, Praat computes the exact DFT with Bluestein's algorithm if %N has large prime factors, "
+	"which takes of the order of %N log %N operations as well, so that `spectrum_dft` is now computed "
+	"about as fast as the two approximations.")
 NORMAL (U"The following picture shows the `spectrum_dft` in black colour, the `spectrum_fft` in silver/grey and the "
 	"`spectrum_resampled` in red. "
 	"From the two alternative approximations of the spectrum, the resampled one looks a better approximation to the DFT than the one with zeros added.")
@@ -1,6 +1,6 @@
 /* Matrix.cpp
  *
- * Copyright (C) 1992-2025 Paul Boersma
+ * Copyright (C) 1992-2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -732,20 +732,68 @@ void Matrix_writeToHeaderlessSpreadsheetFile (const constMatrix me, MelderFile f
 	}
 }
 
+static void Matrix_formula_cells (const mutableMatrix me, const integer ixmin, const integer ixmax, const integer iymin, const integer iymax,
+	conststring32 expression, Interpreter interpreter, const mutableMatrix target)
+{
+	autoFormulaProgram program = FormulaProgram_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+	const integer numberOfColumns = ixmax - ixmin + 1, numberOfRows = iymax - iymin + 1;
+	if (numberOfColumns < 1 || numberOfRows < 1)
+		return;
+	if (! FormulaProgram_isPointwise (program.get())) {
+		/*
+			The formula may read cells that it has already changed (think of `self [col - 1]`),
+			or may have side effects, so the cells have to be computed in order.
+		*/
+		Formula_Result result;
+		for (integer irow = iymin; irow <= iymax; irow ++) {
+			for (integer icol = ixmin; icol <= ixmax; icol ++) {
+				FormulaProgram_run (program.get(), irow, icol, & result);
+				target -> z [irow] [icol] = result. numericResult;
+			}
+		}
+		return;
+	}
+	if (FormulaProgram_isVectorizable (program.get())) {
+		/*
+			The formula can be computed a whole piece of a row at a time.
+			We cut each row into pieces, so that short and tall matrices are both spread over the threads.
+		*/
+		constexpr integer maximumPieceSize = 4096;
+		const integer numberOfPiecesPerRow = (numberOfColumns - 1) / maximumPieceSize + 1;
+		const integer numberOfPieces = numberOfRows * numberOfPiecesPerRow;
+		MelderThread_PARALLEL (numberOfPieces, 4) {
+			MelderThread_FOR (ipiece) {
+				const integer irow = iymin + (ipiece - 1) / numberOfPiecesPerRow;
+				const integer firstColumn = ixmin + ((ipiece - 1) % numberOfPiecesPerRow) * maximumPieceSize;
+				const integer lastColumn = std::min (firstColumn + maximumPieceSize - 1, ixmax);
+				FormulaProgram_runRow (program.get(), irow, firstColumn, target -> z.row (irow). part (firstColumn, lastColumn));
+			}
+		} MelderThread_ENDPARALLEL
+		return;
+	}
+	/*
+		Each cell depends only on itself, so the order of computation does not matter.
+		We number the cells row by row, so that the chunks of each thread are contiguous in memory.
+	*/
+	const integer numberOfCells = numberOfRows * numberOfColumns;
+	MelderThread_PARALLEL (numberOfCells, 10'000) {
+		Formula_Result result;
+		MelderThread_FOR (icell) {
+			const integer irow = iymin + (icell - 1) / numberOfColumns;
+			const integer icol = ixmin + (icell - 1) % numberOfColumns;
+			FormulaProgram_run (program.get(), irow, icol, & result);
+			target -> z [irow] [icol] = result. numericResult;
+		}
+	} MelderThread_ENDPARALLEL
+}
+
 void Matrix_formula (const mutableMatrix me,
 	conststring32 expression, Interpreter interpreter, /* mutable default */ mutableMatrix target)
 {
 	try {
-		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-		Formula_Result result;
 		if (! target)
 			target = me;
-		for (integer irow = 1; irow <= my ny; irow ++) {
-			for (integer icol = 1; icol <= my nx; icol ++) {
-				Formula_run (irow, icol, & result);
-				target -> z [irow] [icol] = result. numericResult;
-			}
-		}
+		Matrix_formula_cells (me, 1, my nx, 1, my ny, expression, interpreter, target);
 	} catch (MelderError) {
 		Melder_throw (me, U": formula not completed.");
 	}
@@ -763,16 +811,9 @@ void Matrix_formula_part (const mutableMatrix me, double xmin, double xmax, doub
 		integer ixmin, ixmax, iymin, iymax;
 		(void) Matrix_getWindowSamplesX (me, xmin, xmax, & ixmin, & ixmax);
 		(void) Matrix_getWindowSamplesY (me, ymin, ymax, & iymin, & iymax);
-		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-		Formula_Result result;
 		if (! target)
 			target = me;
-		for (integer irow = iymin; irow <= iymax; irow ++) {
-			for (integer icol = ixmin; icol <= ixmax; icol ++) {
-				Formula_run (irow, icol, & result);
-				target -> z [irow] [icol] = result. numericResult;
-			}
-		}
+		Matrix_formula_cells (me, ixmin, ixmax, iymin, iymax, expression, interpreter, target);
 	} catch (MelderError) {
 		Melder_throw (me, U": formula not completed.");
 	}
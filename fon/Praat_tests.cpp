@@ -697,6 +697,112 @@ int Praat_tests (kPraatTests itest, conststring32 arg1, conststring32 arg2, cons
 				Melder_stopwatch();
 			t = stopwatch ();
 		} break;
+		case kPraatTests::TIME_FFT: {
+			/*
+				For sizes 2^k, 3 * 2^k and 5 * 2^k between arg2 and arg3
+				(or, if arg4 is "primes", for the smallest prime p above every 2^k, and for 2 p),
+				transform about arg1 points forward and backward, with FFTPACK as well as with the mixed-radix transform
+				(or Bluestein's algorithm), and check that both transforms give the same results.
+			*/
+			const integer minimumSize = Melder_atoi (arg2), maximumSize = Melder_atoi (arg3);
+			Melder_require (minimumSize >= 2 && maximumSize >= minimumSize,
+				U"The sizes should be at least 2 and in increasing order.");
+			const bool primes = Melder_equ (arg4, U"primes");
+			auto isPrime = [] (integer number) {
+				for (integer divisor = 2; divisor * divisor <= number; divisor ++)
+					if (number % divisor == 0)
+						return false;
+				return true;
+			};
+			autoINTVEC sizes = raw_INTVEC (0);
+			for (integer power = 1; power <= maximumSize; power *= 2) {
+				integer prime = power + 1;
+				while (! isPrime (prime))
+					prime ++;
+				for (integer factor = 1; factor <= ( primes ? 2 : 5 ); factor += ( primes ? 1 : 2 )) {
+					const integer size = factor * ( primes ? prime : power );
+					if (size >= minimumSize && size <= maximumSize)
+						*sizes. append () = size;
+				}
+			}
+			sort_INTVEC_inout (sizes.get());
+			MelderInfo_writeLine (U"size\tFFTPACK\t", NUMfft_instructionSet (), U"\tspeed-up\t", NUMfft_instructionSet (), U" float\terror\t(nanoseconds per point per transform)");
+			for (integer isize = 1; isize <= sizes.size; isize ++) {
+				const integer size = sizes [isize];
+				const integer numberOfIterations = std::max (n / size / 3, 1_integer);
+				autoVEC x = randomGauss_VEC (size, 0.0, 1.0);
+				autoNUMFourierTable fftpackTable = NUMFourierTable_create_fftpack (size);
+				autoNUMFourierTable table = NUMFourierTable_create (size);
+				/*
+					Correctness.
+				*/
+				autoVEC fftpackSpectrum = copy_VEC (x.get()), spectrum = copy_VEC (x.get());
+				NUMfft_forward (fftpackTable.get(), fftpackSpectrum.get());
+				NUMfft_forward (table.get(), spectrum.get());
+				double maximumError = 0.0, maximumValue = 0.0;
+				for (integer i = 1; i <= size; i ++) {
+					maximumError = std::max (maximumError, fabs (spectrum [i] - fftpackSpectrum [i]));
+					maximumValue = std::max (maximumValue, fabs (fftpackSpectrum [i]));
+				}
+				NUMfft_backward (table.get(), spectrum.get());
+				for (integer i = 1; i <= size; i ++)
+					maximumError = std::max (maximumError, fabs (spectrum [i] / size - x [i]) * sqrt (size));
+				const double relativeError = maximumError / maximumValue;
+				/*
+					For a large prime factor p, the error of FFTPACK itself grows as p^1.5.
+				*/
+				const double tolerance = ( primes ? 1e-15 * size * sqrt (size) + 1e-12 : 1e-12 );
+				Melder_require (relativeError < tolerance,
+					U"FFT of size ", size, U": the fast transform differs from FFTPACK by ", relativeError, U".");
+				/*
+					Speed.
+				*/
+				auto timeTransforms = [&] (NUMFourierTable fourierTable, auto& data) {
+					const double scale = 1.0 / size;
+					double shortestTime = undefined;
+					for (integer round = 1; round <= 3; round ++) {   // against disturbances by other processes
+						MelderStopwatch stopwatch;
+						for (integer iteration = 1; iteration <= numberOfIterations; iteration ++) {
+							NUMfft_forward (fourierTable, data.get());
+							NUMfft_backward (fourierTable, data.get());
+							for (integer i = 1; i <= size; i ++)
+								data [i] *= scale;
+						}
+						const double time = stopwatch ();
+						if (isundef (shortestTime) || time < shortestTime)
+							shortestTime = time;
+					}
+					return shortestTime / (2.0 * numberOfIterations * size);
+				};
+				autoVEC data = copy_VEC (x.get());
+				const double fftpackTime = timeTransforms (fftpackTable.get(), data);
+				const double mixedRadixTime = timeTransforms (table.get(), data);
+				autovector <float> floatData = newvectorraw <float> (size);
+				for (integer i = 1; i <= size; i ++)
+					floatData [i] = (float) x [i];
+				const double floatTime = timeTransforms (table.get(), floatData);
+				t += mixedRadixTime * n / sizes.size;   // so that the last line gives the average time per point
+				MelderInfo_writeLine (size, U"\t", Melder_fixed (fftpackTime * 1e9, 3), U"\t", Melder_fixed (mixedRadixTime * 1e9, 3),
+					U"\t", Melder_fixed (fftpackTime / mixedRadixTime, 2), U"\t", Melder_fixed (floatTime * 1e9, 3), U"\t", relativeError);
+			}
+		} break;
+		case kPraatTests::FFT_CACHE: {
+			/*
+				Report the state of the process-wide cache of Fourier tables,
+				after emptying it if arg1 is "clear", and after setting its memory budget to arg2 bytes if arg2 is given.
+			*/
+			if (Melder_equ (arg1, U"clear"))
+				NUMFourierTable_clearCache ();
+			if (Melder_length (arg2) > 0)
+				NUMFourierTable_setCacheBudget (Melder_atoi (arg2));
+			const NUMFourierTableCacheStatistics statistics = NUMFourierTable_getCacheStatistics ();
+			MelderInfo_writeLine (U"hits: ", statistics.numberOfHits);
+			MelderInfo_writeLine (U"misses: ", statistics.numberOfMisses);
+			MelderInfo_writeLine (U"dropped tables: ", statistics.numberOfDroppedTables);
+			MelderInfo_writeLine (U"cached tables: ", statistics.numberOfTables);
+			MelderInfo_writeLine (U"bytes: ", statistics.numberOfBytes);
+			MelderInfo_writeLine (U"budget: ", statistics.budget);
+		} break;
 	}
 	MelderInfo_writeLine (Melder_single (t * 1e9 / n), U" nanoseconds per iteration");
 	MelderInfo_close ();
@@ -1,6 +1,6 @@
 /* Sound.cpp
  *
- * Copyright (C) 1992-2025 Paul Boersma
+ * Copyright (C) 1992-2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -22,7 +22,9 @@
  * pb 2010/03/26 Sounds_convolve, Sounds_crossCorrelate, Sound_autocorrelate
  */
 
+#include <numeric>   // std::gcd
 #include "Sound.h"
+#include "Sound_and_Spectrum.h"
 #include "Sound_extensions.h"
 #include "NUM2.h"
 
@@ -390,6 +392,62 @@ autoSound Sound_upsample (constSound me) {
 	}
 }
 
+/*
+	Sound_resample computes every new sample as a weighted sum of the old samples around it,
+	with a windowed sinc as the weighting function.
+	When upsampling, these weights are the same as those of NUM_interpolate_sinc.
+	When downsampling, the sinc is stretched so that its cut-off lies at the new Nyquist frequency,
+	so that the weighting also serves as the anti-aliasing filter;
+	the depth of the filter is then measured in new samples, so that it has the same quality for every ratio.
+
+	The weights depend only on the "phase" of the new sample, i.e. on its position between two old samples.
+	If the two sampling frequencies are whole numbers, the phases repeat after a number of new samples
+	(e.g. 160 when going from 44100 to 16000 Hz), and all the weights are computed beforehand ("polyphase filtering");
+	otherwise, the weights are computed beforehand for a fixed number of equally spaced phases,
+	and the result is interpolated linearly between the two neighbouring phases.
+*/
+static void computeResamplingWeights (VEC const& weights, double fraction, double cutoff, integer depth) {
+	/*
+		weights [k] belongs to the old sample that lies `fraction + numberOfTapsPerSide - k` old samples
+		to the left of the new sample (a negative distance means that it lies to the right).
+	*/
+	const integer numberOfTapsPerSide = weights.size / 2;
+	if (cutoff == 1.0 && fraction == 0.0) {
+		weights  <<=  0.0;
+		weights [numberOfTapsPerSide] = 1.0;   // the interpolated curve goes through the points
+		return;
+	}
+	const double halfWindowWidth = (depth + 0.5) / cutoff;   // in old samples; as in NUM_interpolate_sinc for cutoff 1
+	for (integer k = 1; k <= weights.size; k ++) {
+		const double distance = fabs (fraction + numberOfTapsPerSide - k);
+		if (distance >= halfWindowWidth) {
+			weights [k] = 0.0;
+			continue;
+		}
+		const double sincPhase = NUMpi * cutoff * distance;
+		const double sinc = ( sincPhase == 0.0 ? 1.0 : sin (sincPhase) / sincPhase );
+		weights [k] = cutoff * sinc * 0.5 * (1.0 + cos (NUMpi * distance / halfWindowWidth));
+	}
+}
+
+static inline double innerProduct (const double *x, const double *y, integer n) {
+	double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;   // four independent sums, so that the processor need not wait
+	integer i = 0;
+	for (; i + 3 < n; i += 4) {
+		sum0 += x [i] * y [i];
+		sum1 += x [i + 1] * y [i + 1];
+		sum2 += x [i + 2] * y [i + 2];
+		sum3 += x [i + 3] * y [i + 3];
+	}
+	for (; i < n; i ++)
+		sum0 += x [i] * y [i];
+	return (sum0 + sum1) + (sum2 + sum3);
+}
+
+static bool isWholeNumber (double x) {
+	return x >= 1.0 && x < 1e9 && fabs (x - round (x)) < 1e-9 * x;
+}
+
 autoSound Sound_resample (constSound me, double samplingFrequency, integer precision) {
 	const double upfactor = samplingFrequency * my dx;
 	if (fabs (upfactor - 2.0) < 1e-6)
@@ -400,50 +458,132 @@ autoSound Sound_resample (constSound me, double samplingFrequency, integer preci
 		const integer numberOfSamples = Melder_iround ((my xmax - my xmin) * samplingFrequency);
 		if (numberOfSamples < 1)
 			Melder_throw (U"The resampled Sound would have no samples.");
-		autoSound filtered;
-		const bool weNeedAnAntiAliasingFilter = ( upfactor < 1.0 );
-		if (weNeedAnAntiAliasingFilter) {
-			constexpr integer antiTurnAround = 1000;
-			constexpr integer numberOfPaddingSides = 2;   // namely beginning and end
-			const integer nfft = Melder_iroundUpToPowerOfTwo (my nx + antiTurnAround * numberOfPaddingSides);
-			autoVEC data = raw_VEC (nfft);   // will be zeroed in every turn of the loop
-			filtered = Sound_create (my ny, my xmin, my xmax, my nx, my dx, my x1);
-			for (integer ichan = 1; ichan <= my ny; ichan ++) {
-				for (integer i = 1; i <= nfft; i ++)
-					data [i] = 0.0;
-				data.part (antiTurnAround + 1, antiTurnAround + my nx)  <<=  my z.row (ichan);
-				NUMrealft (data.get(), 1);   // go to the frequency domain
-				for (integer i = Melder_ifloor (upfactor * nfft); i <= nfft; i ++)
-					data [i] = 0.0;   // filter away high frequencies
-				data [2] = 0.0;
-				NUMrealft (data.get(), -1);   // return to the time domain
-				const double factor = 1.0 / nfft;
-				const VEC to = filtered -> z.row (ichan);
-				for (integer i = 1; i <= my nx; i ++)
-					to [i] = data [i + antiTurnAround] * factor;
-			}
-			me = filtered.get();   // reference copy; remove at end
-		}
 		autoSound thee = Sound_create (my ny, my xmin, my xmax, numberOfSamples, 1.0 / samplingFrequency,
 				0.5 * (my xmin + my xmax - (numberOfSamples - 1) / samplingFrequency));
-		for (integer ichan = 1; ichan <= my ny; ichan ++) {
-			if (precision <= 1) {
-				for (integer i = 1; i <= numberOfSamples; i ++) {
-					const double x = Sampled_indexToX (thee.get(), i);
-					const double index = Sampled_xToIndex (me, x);
-					const integer leftSample = Melder_ifloor (index);
-					const double fraction = index - leftSample;
-					thy z [ichan] [i] = ( leftSample < 1 || leftSample >= my nx ? 0.0 :
-							(1 - fraction) * my z [ichan] [leftSample] + fraction * my z [ichan] [leftSample + 1] );
-				}
-			} else {
+		const bool weNeedAnAntiAliasingFilter = ( upfactor < 1.0 );
+		if (! weNeedAnAntiAliasingFilter && precision <= NUM_VALUE_INTERPOLATE_CUBIC) {
+			for (integer ichan = 1; ichan <= my ny; ichan ++) {
 				for (integer i = 1; i <= numberOfSamples; i ++) {
 					const double x = Sampled_indexToX (thee.get(), i);
 					const double index = Sampled_xToIndex (me, x);
-					thy z [ichan] [i] = NUM_interpolate_sinc (my z.row (ichan), index, precision);
+					if (precision <= 1) {
+						const integer leftSample = Melder_ifloor (index);
+						const double fraction = index - leftSample;
+						thy z [ichan] [i] = ( leftSample < 1 || leftSample >= my nx ? 0.0 :
+								(1 - fraction) * my z [ichan] [leftSample] + fraction * my z [ichan] [leftSample + 1] );
+					} else {
+						thy z [ichan] [i] = NUM_interpolate_sinc (my z.row (ichan), index, precision);
+					}
 				}
 			}
+			return thee;
 		}
+		/*
+			The windowed sinc.
+		*/
+		const integer depth = std::max (precision, 1_integer);
+		const double cutoff = std::min (upfactor, 1.0);   // relative to the old Nyquist frequency
+		const integer numberOfTapsPerSide = Melder_iroundUp (depth / cutoff - 1e-9);
+		const integer numberOfTaps = 2 * numberOfTapsPerSide;
+		/*
+			The phases.
+		*/
+		constexpr integer maximumNumberOfWeights = 4'000'000;   // 32 megabytes
+		const double oldSamplingFrequency = 1.0 / my dx;
+		integer upsamplingFactor = 0, downsamplingFactor = 0;   // zero if the ratio is not a fraction of whole numbers
+		if (isWholeNumber (oldSamplingFrequency) && isWholeNumber (samplingFrequency)) {
+			const integer oldRate = Melder_iround (oldSamplingFrequency), newRate = Melder_iround (samplingFrequency);
+			const integer greatestCommonDivisor = std::gcd (oldRate, newRate);
+			if (newRate / greatestCommonDivisor * numberOfTaps <= maximumNumberOfWeights) {
+				upsamplingFactor = newRate / greatestCommonDivisor;
+				downsamplingFactor = oldRate / greatestCommonDivisor;
+			}
+		}
+		const bool isPolyphase = ( upsamplingFactor > 0 );
+		const integer numberOfPhases = ( isPolyphase ? upsamplingFactor :
+				Melder_clipped (1_integer, maximumNumberOfWeights / numberOfTaps - 1, 1024_integer) );
+		const integer numberOfTables = ( isPolyphase ? numberOfPhases : numberOfPhases + 1 );   // the extra one for interpolating the last phase
+		/*
+			The first new sample lies at `firstIndex`, measured in old samples;
+			in the polyphase case, new sample `i` lies at `firstIndex + (i - 1) * downsamplingFactor / upsamplingFactor`.
+		*/
+		const double firstIndex = Sampled_xToIndex (me, Sampled_indexToX (thee.get(), 1));
+		const integer firstIndex_floor = Melder_ifloor (firstIndex);
+		const double firstIndex_fraction = firstIndex - firstIndex_floor;
+		autoMAT weights = raw_MAT (numberOfTables, numberOfTaps);
+		autoINTVEC carries = zero_INTVEC (numberOfTables);
+		for (integer itable = 1; itable <= numberOfTables; itable ++) {
+			double fraction = ( isPolyphase ?
+					firstIndex_fraction + (double) (itable - 1) / numberOfPhases :
+					(double) (itable - 1) / numberOfPhases );
+			if (isPolyphase && fraction >= 1.0) {
+				carries [itable] = 1;
+				fraction -= 1.0;
+			}
+			computeResamplingWeights (weights.row (itable), fraction, cutoff, depth);
+		}
+		/*
+			Compute the new samples in pieces, so that short and long sounds are both spread over the threads.
+		*/
+		constexpr integer maximumPieceSize = 4096;
+		const integer numberOfPiecesPerChannel = (numberOfSamples - 1) / maximumPieceSize + 1;
+		const integer numberOfPieces = my ny * numberOfPiecesPerChannel;
+		MelderThread_PARALLEL (numberOfPieces, 1) {
+			MelderThread_FOR (ipiece) {
+				const integer ichan = 1 + (ipiece - 1) / numberOfPiecesPerChannel;
+				const integer firstSample = 1 + ((ipiece - 1) % numberOfPiecesPerChannel) * maximumPieceSize;
+				const integer lastSample = std::min (firstSample + maximumPieceSize - 1, numberOfSamples);
+				const constVEC from = my z.row (ichan);
+				const VEC to = thy z.row (ichan);
+				for (integer i = firstSample; i <= lastSample; i ++) {
+					integer midleft, itable;
+					double phaseFraction = 0.0;   // only for the non-polyphase case
+					if (isPolyphase) {
+						const int64 step = (int64) (i - 1) * downsamplingFactor;
+						itable = 1 + (integer) (step % upsamplingFactor);
+						midleft = firstIndex_floor + (integer) (step / upsamplingFactor) + carries [itable];
+					} else {
+						const double index = Sampled_xToIndex (me, Sampled_indexToX (thee.get(), i));
+						midleft = Melder_ifloor (index);
+						const double phase = (index - midleft) * numberOfPhases;
+						itable = 1 + Melder_clipped (0_integer, Melder_ifloor (phase), numberOfPhases - 1);
+						phaseFraction = phase - (itable - 1);
+					}
+					/*
+						Taps that fall outside the old sound.
+					*/
+					integer firstTap = 1, lastTap = numberOfTaps;
+					const integer firstOldSample = midleft - numberOfTapsPerSide + 1;
+					if (firstOldSample < 1 || midleft + numberOfTapsPerSide > my nx) {
+						if (! weNeedAnAntiAliasingFilter) {
+							/*
+								Near the edges, NUM_interpolate_sinc decreases the depth and extrapolates.
+							*/
+							to [i] = NUM_interpolate_sinc (from, Sampled_xToIndex (me, Sampled_indexToX (thee.get(), i)), depth);
+							continue;
+						}
+						/*
+							The anti-aliasing filter regards the sound as zero outside its time domain.
+						*/
+						firstTap = std::max (firstTap, 2 - firstOldSample);
+						lastTap = std::min (lastTap, my nx - firstOldSample + 1);
+						if (firstTap > lastTap) {
+							to [i] = 0.0;
+							continue;
+						}
+					}
+					const double *samples = & from [firstOldSample + firstTap - 1];
+					const integer n = lastTap - firstTap + 1;
+					const double value = innerProduct (samples, & weights [itable] [firstTap], n);
+					if (isPolyphase) {
+						to [i] = value;
+					} else {
+						const double nextValue = innerProduct (samples, & weights [itable + 1] [firstTap], n);
+						to [i] = value + phaseFraction * (nextValue - value);
+					}
+				}
+			}
+		} MelderThread_ENDPARALLEL
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": not resampled.");
@@ -545,34 +685,46 @@ autoSound Sounds_convolve (constSound me, constSound thee, kSounds_convolve_scal
 		const integer n1 = my nx, n2 = thy nx;
 		const integer n3 = n1 + n2 - 1;
 		const integer nfft = Melder_iroundUpToPowerOfTwo (n3);
-		autoVEC data1 = raw_VEC (nfft);
-		autoVEC data2 = raw_VEC (nfft);
 		integer numberOfChannels = std::max (my ny, thy ny);
 		autoSound him = Sound_create (numberOfChannels, my xmin + thy xmin, my xmax + thy xmax, n3, my dx, my x1 + thy x1);
-		for (integer channel = 1; channel <= numberOfChannels; channel ++) {
-			VEC a = my z.row (my ny == 1 ? 1 : channel);
-			for (integer i = n1; i > 0; i --)
-				data1 [i] = a [i];
-			for (integer i = n1 + 1; i <= nfft; i ++)
-				data1 [i] = 0.0;
-			a = thy z.row (thy ny == 1 ? 1 : channel);
-			for (integer i = n2; i > 0; i --)
-				data2 [i] = a [i];
-			for (integer i = n2 + 1; i <= nfft; i ++)
-				data2 [i] = 0.0;
-			NUMrealft (data1.get(), 1);
-			NUMrealft (data2.get(), 1);
-			data2 [1] *= data1 [1];
-			data2 [2] *= data1 [2];
-			for (integer i = 3; i <= nfft; i += 2) {
-				const double temp = data1 [i] * data2 [i] - data1 [i + 1] * data2 [i + 1];
-				data2 [i + 1] = data1 [i] * data2 [i + 1] + data1 [i + 1] * data2 [i];
-				data2 [i] = temp;
+		/*
+			If one sound is much shorter than the other (e.g. a filter kernel),
+			we convolve in blocks, in parallel; otherwise, we transform both sounds as a whole.
+		*/
+		const constSound longer = ( n1 >= n2 ? me : thee ), shorter = ( n1 >= n2 ? thee : me );
+		double fourierScaling;
+		if (4 * shorter -> nx <= longer -> nx) {
+			convolve_overlapSave_MAT_out (his z.get(), longer -> z.get(), shorter -> z.get(), 0);
+			fourierScaling = 1.0;
+		} else {
+			autoVEC data1 = raw_VEC (nfft);
+			autoVEC data2 = raw_VEC (nfft);
+			for (integer channel = 1; channel <= numberOfChannels; channel ++) {
+				VEC a = my z.row (my ny == 1 ? 1 : channel);
+				for (integer i = n1; i > 0; i --)
+					data1 [i] = a [i];
+				for (integer i = n1 + 1; i <= nfft; i ++)
+					data1 [i] = 0.0;
+				a = thy z.row (thy ny == 1 ? 1 : channel);
+				for (integer i = n2; i > 0; i --)
+					data2 [i] = a [i];
+				for (integer i = n2 + 1; i <= nfft; i ++)
+					data2 [i] = 0.0;
+				NUMrealft (data1.get(), 1);
+				NUMrealft (data2.get(), 1);
+				data2 [1] *= data1 [1];
+				data2 [2] *= data1 [2];
+				for (integer i = 3; i <= nfft; i += 2) {
+					const double temp = data1 [i] * data2 [i] - data1 [i + 1] * data2 [i + 1];
+					data2 [i + 1] = data1 [i] * data2 [i + 1] + data1 [i + 1] * data2 [i];
+					data2 [i] = temp;
+				}
+				NUMrealft (data2.get(), -1);
+				a = his z.row (channel);
+				for (integer i = 1; i <= n3; i ++)
+					a [i] = data2 [i];
 			}
-			NUMrealft (data2.get(), -1);
-			a = his z.row (channel);
-			for (integer i = 1; i <= n3; i ++)
-				a [i] = data2 [i];
+			fourierScaling = 1.0 / nfft;
 		}
 		switch (signalOutsideTimeDomain) {
 			case kSounds_convolve_signalOutsideTimeDomain::ZERO: {
@@ -596,15 +748,15 @@ autoSound Sounds_convolve (constSound me, constSound thee, kSounds_convolve_scal
 		}
 		switch (scaling) {
 			case kSounds_convolve_scaling::INTEGRAL: {
-				Vector_multiplyByScalar (him.get(), my dx / nfft);
+				Vector_multiplyByScalar (him.get(), my dx * fourierScaling);
 			} break;
 			case kSounds_convolve_scaling::SUM: {
-				Vector_multiplyByScalar (him.get(), 1.0 / nfft);
+				Vector_multiplyByScalar (him.get(), fourierScaling);
 			} break;
 			case kSounds_convolve_scaling::NORMALIZE: {
 				double normalizationFactor = Matrix_getNorm (me) * Matrix_getNorm (thee);
 				if (normalizationFactor != 0.0)
-					Vector_multiplyByScalar (him.get(), 1.0 / nfft / normalizationFactor);
+					Vector_multiplyByScalar (him.get(), fourierScaling / normalizationFactor);
 			} break;
 			case kSounds_convolve_scaling::PEAK_099: {
 				Vector_scale (him.get(), 0.99);
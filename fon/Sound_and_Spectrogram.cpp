@@ -1,6 +1,6 @@
 /* Sound_and_Spectrogram.cpp
  *
- * Copyright (C) 1992-2011,2014-2020,2023,2025 Paul Boersma
+ * Copyright (C) 1992-2011,2014-2020,2023,2025,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -129,19 +129,41 @@ autoSpectrogram Sound_to_Spectrogram_e (
 
 		autoMelderProgress progress (U"Sound to Spectrogram...");
 
-		MelderThread_PARALLEL (numberOfTimes, 15) {
-			autoVEC data = zero_VEC (nsampFFT);
-			autoVEC spectrum = zero_VEC (half_nsampFFT + 1);
-			autoNUMFourierTable fftTable = NUMFourierTable_create (nsampFFT);
-			MelderThread_FOR (iframe) {
-				const double t = Sampled_indexToX (thee.get(), iframe);
-				const integer leftSample = Sampled_xToLowIndex (me, t), rightSample = leftSample + 1;
-				const integer startSample = rightSample - halfnsamp_window;
-				const integer endSample = leftSample + halfnsamp_window;
-				Melder_assert (startSample >= 1);
-				Melder_assert (endSample <= my nx);
-
-				spectrum.all()  <<=  0.0;
+		/*
+			The frames are analysed in blocks, so that each channel of a block
+			can be windowed and transformed by a single call to NUMfft_forward_batch.
+		*/
+		constexpr integer numberOfFramesPerBlock = 16;
+		const integer numberOfBlocks = (numberOfTimes - 1) / numberOfFramesPerBlock + 1;
+		MelderThread_PARALLEL (numberOfBlocks, 1) {
+			autoMAT frames = raw_MAT (numberOfFramesPerBlock, nsampFFT);
+			autoMAT spectra = raw_MAT (numberOfFramesPerBlock, half_nsampFFT + 1);
+			autoINTVEC firstSamples = raw_INTVEC (numberOfFramesPerBlock);
+			sharedNUMFourierTable fftTable = NUMFourierTable_getShared (nsampFFT);
+			MelderThread_FOR (iblock) {
+				const integer firstFrame = (iblock - 1) * numberOfFramesPerBlock + 1;
+				const integer numberOfFramesInBlock = std::min (numberOfFramesPerBlock, numberOfTimes - firstFrame + 1);
+				const MAT blockFrames (& frames [1] [1], numberOfFramesInBlock, nsampFFT);
+				const INTVEC blockFirstSamples = firstSamples.part (1, numberOfFramesInBlock);
+				for (integer iframe = 1; iframe <= numberOfFramesInBlock; iframe ++) {
+					const double t = Sampled_indexToX (thee.get(), firstFrame - 1 + iframe);
+					const integer leftSample = Sampled_xToLowIndex (me, t), rightSample = leftSample + 1;
+					const integer startSample = rightSample - halfnsamp_window;
+					const integer endSample = leftSample + halfnsamp_window;
+					Melder_assert (startSample >= 1);
+					Melder_assert (endSample <= my nx);
+					blockFirstSamples [iframe] = startSample;
+				}
+
+				if (MelderThread_IS_MASTER) {   // then we can interact with the GUI
+					const double estimatedProgress = MelderThread_ESTIMATED_PROGRESS;
+					Melder_progress (estimatedProgress,
+						U"Sound to Spectrogram: analysed approximately ", Melder_iround (numberOfTimes * estimatedProgress),
+						U" out of ", numberOfTimes, U" frames"
+					);
+				}
+
+				spectra.all()  <<=  0.0;
 				/*
 					For multichannel sounds, the power spectrogram should represent the
 					average power in the channels,
@@ -151,47 +173,42 @@ autoSpectrogram Sound_to_Spectrogram_e (
 					Averaging starts by adding up the powers of the channels.
 				*/
 				for (integer channel = 1; channel <= my ny; channel ++) {
-					for (integer j = 1, i = startSample; j <= nsamp_window; j ++)
-						data [j] = my z [channel] [i ++] * window [j];
-					for (integer j = nsamp_window + 1; j <= nsampFFT; j ++)
-						data [j] = 0.0;
-
-					if (MelderThread_IS_MASTER) {   // then we can interact with the GUI
-						const double estimatedProgress = MelderThread_ESTIMATED_PROGRESS;
-						Melder_progress (estimatedProgress,
-							U"Sound to Spectrogram: analysed approximately ", Melder_iround (numberOfTimes * estimatedProgress),
-							U" out of ", numberOfTimes, U" frames"
-						);
-					}
-
 					/*
-						Compute the Fast Fourier Transform of the frame.
+						Window the frames and compute their Fast Fourier Transforms.
 					*/
-					NUMfft_forward (fftTable.get(), data.get());   // data := complex spectrum
+					NUMfft_forward_batch (fftTable.get(), blockFrames,
+							my z.row (channel), blockFirstSamples, window.get(), false);   // frames := complex spectra
 
 					/*
 						Convert from complex to power spectrum,
 						accumulating the power spectra of the channels.
 					*/
-					spectrum [1] += data [1] * data [1];   // DC component
-					for (integer i = 2; i <= half_nsampFFT; i ++)
-						spectrum [i] += data [i + i - 2] * data [i + i - 2] + data [i + i - 1] * data [i + i - 1];
-					spectrum [half_nsampFFT + 1] += data [nsampFFT] * data [nsampFFT];   // Nyquist frequency. Correct??
+					for (integer iframe = 1; iframe <= numberOfFramesInBlock; iframe ++) {
+						const constVEC data = blockFrames.row (iframe);
+						const VEC spectrum = spectra.row (iframe);
+						spectrum [1] += data [1] * data [1];   // DC component
+						for (integer i = 2; i <= half_nsampFFT; i ++)
+							spectrum [i] += data [i + i - 2] * data [i + i - 2] + data [i + i - 1] * data [i + i - 1];
+						spectrum [half_nsampFFT + 1] += data [nsampFFT] * data [nsampFFT];   // Nyquist frequency. Correct??
+					}
 				}
-				/*
-					Power averaging ends by dividing the summed power by the number of channels,
-				*/
-				if (my ny > 1 )
-					spectrum.all()  /=  my ny;
+				for (integer iframe = 1; iframe <= numberOfFramesInBlock; iframe ++) {
+					const VEC spectrum = spectra.row (iframe);
+					/*
+						Power averaging ends by dividing the summed power by the number of channels,
+					*/
+					if (my ny > 1 )
+						spectrum  /=  my ny;
 
-				/*
-					Binning.
-				*/
-				for (integer iband = 1; iband <= numberOfFreqs; iband ++) {
-					const integer lowerSample = (iband - 1) * binWidth_samples + 1;
-					const integer higherSample = lowerSample + binWidth_samples;
-					const double power = NUMsum (spectrum.part (lowerSample, higherSample - 1));
-					thy z [iband] [iframe] = power * oneByBinWidth;
+					/*
+						Binning.
+					*/
+					for (integer iband = 1; iband <= numberOfFreqs; iband ++) {
+						const integer lowerSample = (iband - 1) * binWidth_samples + 1;
+						const integer higherSample = lowerSample + binWidth_samples;
+						const double power = NUMsum (spectrum.part (lowerSample, higherSample - 1));
+						thy z [iband] [firstFrame - 1 + iframe] = power * oneByBinWidth;
+					}
 				}
 			}
 		} MelderThread_ENDPARALLEL
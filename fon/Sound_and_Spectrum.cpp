@@ -1,6 +1,6 @@
 /* Sound_and_Spectrum.cpp
  *
- * Copyright (C) 1992-2005,2011,2012,2015-2021,2025 Paul Boersma
+ * Copyright (C) 1992-2005,2011,2012,2015-2021,2025,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,6 +17,7 @@
  */
 
 #include "Sound_and_Spectrum.h"
+#include "LongSound.h"
 #include "NUM2.h"
 
 autoSpectrum Sound_to_Spectrum (Sound me, bool fast) {
@@ -29,7 +30,7 @@ autoSpectrum Sound_to_Spectrum (Sound me, bool fast) {
 		columnMeans_VEC_out (data.part (1, my nx), my z.all());
 		data.part (my nx + 1, numberOfFourierSamples)  <<=  0.0;
 
-		autoNUMFourierTable fourierTable = NUMFourierTable_create (numberOfFourierSamples);
+		sharedNUMFourierTable fourierTable = NUMFourierTable_getShared (numberOfFourierSamples);
 		NUMfft_forward (fourierTable.get(), data.get());
 
 		autoSpectrum thee = Spectrum_create (0.5 / my dx, numberOfFrequencies);
@@ -149,24 +150,60 @@ autoSound Sound_filter_formula (Sound me, conststring32 formula, Interpreter int
 	}
 }
 
-autoSound Sound_filter_passHannBand (Sound me, double fmin, double fmax, double smooth) {
-	try {
-		autoSound thee = Data_copy (me);
-		if (my ny == 1) {
-			autoSpectrum spec = Sound_to_Spectrum (me, true);
-			Spectrum_passHannBand (spec.get(), fmin, fmax, smooth);
-			autoSound him = Spectrum_to_Sound (spec.get());
-			thy z.row (1)  <<=  his z.row (1).part (1, thy nx);
-		} else {
-			for (integer ichan = 1; ichan <= my ny; ichan ++) {
-				autoSound channel = Sound_extractChannel (me, ichan);
-				autoSpectrum spec = Sound_to_Spectrum (channel.get(), true);
-				Spectrum_passHannBand (spec.get(), fmin, fmax, smooth);
-				autoSound him = Spectrum_to_Sound (spec.get());
-				thy z.row (ichan)  <<=  his z.row (1).part (1, thy nx);
+/*
+	Filter the channels of a sound in the frequency domain exactly as
+	Sound_to_Spectrum (fast), `filter`, and Spectrum_to_Sound would do for each channel,
+	but without copying each channel into a separate Sound, and with the channels in parallel.
+	The filter should multiply each frequency bin by a real factor
+	(so that the Spectrum keeps having the same number of samples).
+*/
+template <typename SpectralFilter>
+static autoSound Sound_filterInFrequencyDomain (Sound me, SpectralFilter filter) {
+	autoSound thee = Sound_create (my ny, my xmin, my xmax, my nx, my dx, my x1);
+	const integer numberOfFourierSamples = Melder_iroundUpToPowerOfTwo (my nx);
+	const integer numberOfFrequencies = numberOfFourierSamples / 2 + 1;
+	const double samplingScaling = my dx, frequencyScaling = 1.0 / (my dx * numberOfFourierSamples);
+	sharedNUMFourierTable fourierTable = NUMFourierTable_getShared (numberOfFourierSamples);
+	MelderThread_PARALLEL (my ny, 1) {
+		autoVEC data = raw_VEC (numberOfFourierSamples);
+		autoSpectrum spectrum = Spectrum_create (0.5 / my dx, numberOfFrequencies);
+		spectrum -> dx = frequencyScaling;
+		const VEC re = spectrum -> z.row (1), im = spectrum -> z.row (2);
+		MelderThread_FOR (ichan) {
+			data.part (1, my nx)  <<=  my z.row (ichan);
+			data.part (my nx + 1, numberOfFourierSamples)  <<=  0.0;
+			NUMfft_forward (fourierTable.get(), data.get());
+			re [1] = data [1] * samplingScaling;
+			im [1] = 0.0;
+			if (numberOfFourierSamples > 1) {
+				for (integer i = 2; i < numberOfFrequencies; i ++) {
+					re [i] = data [i + i - 2] * samplingScaling;
+					im [i] = data [i + i - 1] * samplingScaling;
+				}
+				re [numberOfFrequencies] = data [numberOfFourierSamples] * samplingScaling;
+				im [numberOfFrequencies] = 0.0;
+			}
+			filter (spectrum.get());
+			data [1] = re [1] * frequencyScaling;
+			if (numberOfFourierSamples > 1) {
+				for (integer i = 2; i < numberOfFrequencies; i ++) {
+					data [i + i - 2] = re [i] * frequencyScaling;
+					data [i + i - 1] = im [i] * frequencyScaling;
+				}
+				data [numberOfFourierSamples] = re [numberOfFrequencies] * frequencyScaling;
 			}
+			NUMfft_backward (fourierTable.get(), data.get());
+			thy z.row (ichan)  <<=  data.part (1, my nx);
 		}
-		return thee;
+	} MelderThread_ENDPARALLEL
+	return thee;
+}
+
+autoSound Sound_filter_passHannBand (Sound me, double fmin, double fmax, double smooth) {
+	try {
+		return Sound_filterInFrequencyDomain (me, [=] (Spectrum spectrum) {
+			Spectrum_passHannBand (spectrum, fmin, fmax, smooth);
+		});
 	} catch (MelderError) {
 		Melder_throw (me, U": not filtered (pass Hann band).");
 	}
@@ -174,24 +211,249 @@ autoSound Sound_filter_passHannBand (Sound me, double fmin, double fmax, double
 
 autoSound Sound_filter_stopHannBand (Sound me, double fmin, double fmax, double smooth) {
 	try {
-		autoSound thee = Data_copy (me);
-		if (my ny == 1) {
-			autoSpectrum spec = Sound_to_Spectrum (me, true);
-			Spectrum_stopHannBand (spec.get(), fmin, fmax, smooth);
-			autoSound him = Spectrum_to_Sound (spec.get());
-			thy z.row (1)  <<=  his z.row (1).part (1, thy nx);
-		} else {
-			for (integer ichan = 1; ichan <= my ny; ichan ++) {
-				autoSound channel = Sound_extractChannel (me, ichan);
-				autoSpectrum spec = Sound_to_Spectrum (channel.get(), true);
-				Spectrum_stopHannBand (spec.get(), fmin, fmax, smooth);
-				autoSound him = Spectrum_to_Sound (spec.get());
-				thy z.row (ichan)  <<=  his z.row (1).part (1, thy nx);
+		return Sound_filterInFrequencyDomain (me, [=] (Spectrum spectrum) {
+			Spectrum_stopHannBand (spectrum, fmin, fmax, smooth);
+		});
+	} catch (MelderError) {
+		Melder_throw (me, U": not filtered (stop Hann band).");
+	}
+}
+
+autoSpectrum Sound_to_Spectrum_unity (Sound me) {
+	try {
+		const integer numberOfFourierSamples = Melder_iroundUpToPowerOfTwo (my nx);
+		autoSpectrum thee = Spectrum_create (0.5 / my dx, numberOfFourierSamples / 2 + 1);
+		thy dx = 1.0 / (my dx * numberOfFourierSamples);
+		thy z.row (1)  <<=  1.0;
+		thy z.row (2)  <<=  0.0;
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": unity spectrum not created.");
+	}
+}
+
+void Sound_filterWithGain_inplace (Sound me, integer fromChannel, integer toChannel, constVEC const& gain) {
+	const integer numberOfFourierSamples = Melder_iroundUpToPowerOfTwo (my nx);
+	const integer numberOfFrequencies = numberOfFourierSamples / 2 + 1;
+	Melder_assert (gain.size == numberOfFrequencies);
+	Melder_assert (fromChannel >= 1 && toChannel <= my ny);
+	/*
+		The backward transform is scaled by the number of samples; we include this in the gain.
+	*/
+	autoVEC scaledGain = copy_VEC (gain);
+	scaledGain.get()  *=  1.0 / numberOfFourierSamples;
+	sharedNUMFourierTable fourierTable = NUMFourierTable_getShared (numberOfFourierSamples);
+	MelderThread_PARALLEL (toChannel - fromChannel + 1, 1) {
+		autoVEC data = raw_VEC (numberOfFourierSamples);
+		MelderThread_FOR (ichan) {
+			const VEC channel = my z.row (fromChannel - 1 + ichan);
+			data.part (1, my nx)  <<=  channel;
+			data.part (my nx + 1, numberOfFourierSamples)  <<=  0.0;
+			NUMfft_forward (fourierTable.get(), data.get());
+			data [1] *= scaledGain [1];
+			for (integer i = 2; i < numberOfFrequencies; i ++) {
+				data [i + i - 2] *= scaledGain [i];
+				data [i + i - 1] *= scaledGain [i];
 			}
+			if (numberOfFourierSamples > 1)
+				data [numberOfFourierSamples] *= scaledGain [numberOfFrequencies];
+			NUMfft_backward (fourierTable.get(), data.get());
+			channel  <<=  data.part (1, my nx);
 		}
-		return thee;
+	} MelderThread_ENDPARALLEL
+}
+
+/*
+	Overlap-save convolution. Each block of `transformSize` signal samples yields
+	`transformSize - kernelSize + 1` target samples; the transform size is four times the kernel size
+	(so that the overlap costs at most a quarter of the work), but at least 16384 samples (128 kilobytes),
+	which still fits in the level-2 cache, and no larger than needed for the whole target.
+*/
+static integer overlapSave_transformSize (integer kernelSize, integer targetSize) {
+	const integer cacheFriendlySize = Melder_iroundUpToPowerOfTwo (std::max (4 * kernelSize, 16384_integer));
+	const integer wholeSize = Melder_iroundUpToPowerOfTwo (targetSize + kernelSize - 1);
+	return std::min (cacheFriendlySize, wholeSize);
+}
+
+void convolve_overlapSave_MAT_out (MATVU const& target, constMATVU const& signal, constMATVU const& kernels, integer lag) {
+	Melder_assert (signal.nrow == 1 || signal.nrow == target.nrow);
+	Melder_assert (kernels.nrow == 1 || kernels.nrow == target.nrow);
+	const integer kernelSize = kernels.ncol, targetSize = target.ncol;
+	if (targetSize == 0)
+		return;
+	const integer transformSize = overlapSave_transformSize (kernelSize, targetSize);
+	const integer blockSize = transformSize - kernelSize + 1;
+	const integer numberOfBlocks = (targetSize - 1) / blockSize + 1;
+	sharedNUMFourierTable fourierTable = NUMFourierTable_getShared (transformSize);
+	/*
+		The transforms of the kernels, divided by the transform size,
+		so that the backward transform needs no further scaling.
+	*/
+	autoMAT kernelSpectra = zero_MAT (kernels.nrow, transformSize);
+	for (integer ikernel = 1; ikernel <= kernels.nrow; ikernel ++) {
+		kernelSpectra.row (ikernel).part (1, kernelSize)  <<=  kernels.row (ikernel);
+		NUMfft_forward (fourierTable.get(), kernelSpectra.row (ikernel));
+		kernelSpectra.row (ikernel)  *=  1.0 / transformSize;
+	}
+	MelderThread_PARALLEL (target.nrow * numberOfBlocks, 1) {
+		autoVEC data = raw_VEC (transformSize);
+		MelderThread_FOR (itask) {
+			const integer ichan = (itask - 1) / numberOfBlocks + 1, iblock = (itask - 1) % numberOfBlocks + 1;
+			const constVECVU channel = signal.row (signal.nrow == 1 ? 1 : ichan);
+			const constVEC kernelSpectrum = kernelSpectra.row (kernels.nrow == 1 ? 1 : ichan);
+			const integer firstTargetSample = (iblock - 1) * blockSize + 1;
+			const integer numberOfTargetSamples = std::min (blockSize, targetSize - firstTargetSample + 1);
+			/*
+				Target sample i needs the signal from i + lag + 1 - kernelSize to i + lag.
+			*/
+			const integer offset = firstTargetSample + lag - kernelSize;   // data [j] = channel [offset + j]
+			const integer firstInside = Melder_clipped (1_integer, 1 - offset, transformSize + 1);
+			const integer lastInside = Melder_clipped (firstInside - 1, channel.size - offset, transformSize);
+			data.part (1, firstInside - 1)  <<=  0.0;
+			data.part (firstInside, lastInside)  <<=  channel.part (offset + firstInside, offset + lastInside);
+			data.part (lastInside + 1, transformSize)  <<=  0.0;
+			NUMfft_forward (fourierTable.get(), data.get());
+			data [1] *= kernelSpectrum [1];
+			for (integer i = 2; i < transformSize; i += 2) {
+				const double re = data [i] * kernelSpectrum [i] - data [i + 1] * kernelSpectrum [i + 1];
+				data [i + 1] = data [i] * kernelSpectrum [i + 1] + data [i + 1] * kernelSpectrum [i];
+				data [i] = re;
+			}
+			if (transformSize > 1)
+				data [transformSize] *= kernelSpectrum [transformSize];
+			NUMfft_backward (fourierTable.get(), data.get());
+			/*
+				The first kernelSize - 1 samples have wrapped around; the rest is the linear convolution.
+			*/
+			target.row (ichan).part (firstTargetSample, firstTargetSample + numberOfTargetSamples - 1)  <<=
+					data.part (kernelSize, kernelSize + numberOfTargetSamples - 1);
+		}
+	} MelderThread_ENDPARALLEL
+}
+
+/*
+	Stream a LongSound through `convolve_overlapSave_MAT_out` to an audio file,
+	a number of blocks at a time, so that only those blocks have to be in memory.
+*/
+static void LongSound_convolve_toAudioFile (LongSound me, constMATVU const& kernels, integer lag, integer targetSize,
+	MelderFile file, int audioFileType, int numberOfBitsPerSamplePoint)
+{
+	const integer numberOfChannels = my numberOfChannels, kernelSize = kernels.ncol;
+	const integer transformSize = overlapSave_transformSize (kernelSize, targetSize);
+	const integer blockSize = transformSize - kernelSize + 1;
+	constexpr integer numberOfBlocksPerChunk = 32;   // enough to keep all threads busy
+	const integer chunkSize = numberOfBlocksPerChunk * blockSize;
+	autoMAT target = raw_MAT (numberOfChannels, std::min (chunkSize, targetSize));
+	autoMAT signal = raw_MAT (numberOfChannels, target.ncol + kernelSize - 1);
+	autoMAT samples;   // the part of the signal that lies inside the LongSound
+	autoMelderProgress progress (U"Filtering LongSound...");
+	autoMelderFile mfile = MelderFile_create (file);
+	MelderFile_writeAudioFileHeader (file, audioFileType, Melder_iround (my sampleRate), targetSize, numberOfChannels, numberOfBitsPerSamplePoint);
+	for (integer firstTargetSample = 1; firstTargetSample <= targetSize; firstTargetSample += chunkSize) {
+		Melder_progress ((double) (firstTargetSample - 1) / targetSize, U"Filtering ", me, U" to ", MelderFile_messageName (file), U"...");
+		const integer numberOfTargetSamples = std::min (chunkSize, targetSize - firstTargetSample + 1);
+		const integer numberOfSignalSamples = numberOfTargetSamples + kernelSize - 1;
+		const integer offset = firstTargetSample + lag - kernelSize;   // signal [ichan] [j] = sample offset + j of the LongSound
+		const integer firstInside = Melder_clipped (1_integer, 1 - offset, numberOfSignalSamples + 1);
+		const integer lastInside = Melder_clipped (firstInside - 1, my nx - offset, numberOfSignalSamples);
+		if (samples.ncol != lastInside - firstInside + 1)
+			samples = raw_MAT (numberOfChannels, lastInside - firstInside + 1);
+		if (samples.ncol > 0)
+			LongSound_readAudioToFloat (me, samples.get(), offset + firstInside);
+		for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
+			const VEC channel = signal.row (ichan);
+			channel.part (1, firstInside - 1)  <<=  0.0;
+			channel.part (firstInside, lastInside)  <<=  samples.row (ichan);
+			channel.part (lastInside + 1, numberOfSignalSamples)  <<=  0.0;
+		}
+		const MATVU chunkTarget = target.verticalBand (1, numberOfTargetSamples);
+		convolve_overlapSave_MAT_out (chunkTarget, signal.verticalBand (1, numberOfSignalSamples), kernels, kernelSize - 1);
+		MelderFile_writeFloatToAudio (file, chunkTarget, Melder_defaultAudioFileEncoding (audioFileType, numberOfBitsPerSamplePoint), true);
+	}
+	MelderFile_writeAudioFileTrailer (file, audioFileType, Melder_iround (my sampleRate), targetSize, numberOfChannels, numberOfBitsPerSamplePoint);
+	mfile.close ();
+}
+
+/*
+	The impulse response of a whole-sound filter (Sound_filter_passHannBand and the like),
+	for a sound of `kernelSize` samples, with lag 0 at sample kernelSize / 2 + 1 of the kernel.
+*/
+template <typename WholeSoundFilter>
+static autoVEC impulseResponse (double samplingPeriod, integer kernelSize, WholeSoundFilter filter) {
+	Melder_assert (kernelSize % 2 == 0);
+	autoSound impulse = Sound_createSimple (1, kernelSize * samplingPeriod, 1.0 / samplingPeriod);
+	Melder_assert (impulse -> nx == kernelSize);
+	impulse -> z [1] [1] = 1.0;
+	autoSound response = filter (impulse.get());
+	autoVEC kernel = raw_VEC (kernelSize);
+	const integer centre = kernelSize / 2 + 1;
+	for (integer i = 1; i <= kernelSize; i ++)
+		kernel [i] = response -> z [1] [(i - centre + kernelSize) % kernelSize + 1];
+	return kernel;
+}
+
+/*
+	A resolution of 1 Hz, or 1/64 of the smoothing, whichever is finer, but at most 1/16 Hz;
+	a power of two, so that the whole-sound filter gives the same spectral samples for an impulse as for a sound of that length.
+*/
+static integer impulseResponseSize (LongSound me, double smooth) {
+	const double duration = Melder_clipped (1.0, 64.0 / smooth, 16.0);   // in seconds; 16 seconds if smooth is 0
+	return Melder_iroundUpToPowerOfTwo (Melder_iceiling (duration * my sampleRate));
+}
+
+void LongSound_filter_passHannBand_toAudioFile (LongSound me, double fmin, double fmax, double smooth,
+	MelderFile file, int audioFileType, int numberOfBitsPerSamplePoint)
+{
+	try {
+		const integer kernelSize = impulseResponseSize (me, smooth);
+		autoVEC kernel = impulseResponse (my dx, kernelSize, [=] (Sound impulse) {
+			return Sound_filter_passHannBand (impulse, fmin, fmax, smooth);
+		});
+		LongSound_convolve_toAudioFile (me, kernel.get().asmatrix (1, kernelSize), kernelSize / 2, my nx, file, audioFileType, numberOfBitsPerSamplePoint);
 	} catch (MelderError) {
-		Melder_throw (me, U": not filtered (stop Hann band).");
+		Melder_throw (me, U": not filtered (pass Hann band) to ", file, U".");
+	}
+}
+
+void LongSound_filter_stopHannBand_toAudioFile (LongSound me, double fmin, double fmax, double smooth,
+	MelderFile file, int audioFileType, int numberOfBitsPerSamplePoint)
+{
+	try {
+		const integer kernelSize = impulseResponseSize (me, smooth);
+		autoVEC kernel = impulseResponse (my dx, kernelSize, [=] (Sound impulse) {
+			return Sound_filter_stopHannBand (impulse, fmin, fmax, smooth);
+		});
+		LongSound_convolve_toAudioFile (me, kernel.get().asmatrix (1, kernelSize), kernelSize / 2, my nx, file, audioFileType, numberOfBitsPerSamplePoint);
+	} catch (MelderError) {
+		Melder_throw (me, U": not filtered (stop Hann band) to ", file, U".");
+	}
+}
+
+void LongSound_filter_formula_toAudioFile (LongSound me, conststring32 formula, Interpreter interpreter,
+	MelderFile file, int audioFileType, int numberOfBitsPerSamplePoint)
+{
+	try {
+		const integer kernelSize = impulseResponseSize (me, 64.0);
+		autoVEC kernel = impulseResponse (my dx, kernelSize, [=] (Sound impulse) {
+			return Sound_filter_formula (impulse, formula, interpreter);
+		});
+		LongSound_convolve_toAudioFile (me, kernel.get().asmatrix (1, kernelSize), kernelSize / 2, my nx, file, audioFileType, numberOfBitsPerSamplePoint);
+	} catch (MelderError) {
+		Melder_throw (me, U": not filtered (formula) to ", file, U".");
+	}
+}
+
+void LongSound_Sound_convolve_toAudioFile (LongSound me, constSound kernel,
+	MelderFile file, int audioFileType, int numberOfBitsPerSamplePoint)
+{
+	try {
+		Melder_require (kernel -> ny == 1 || kernel -> ny == my numberOfChannels,
+			U"The Sound should have one channel or the same number of channels as the LongSound.");
+		Melder_require (kernel -> dx == my dx,
+			U"The sampling frequencies of the LongSound and the Sound should be equal.");
+		LongSound_convolve_toAudioFile (me, kernel -> z.get(), 0, my nx + kernel -> nx - 1, file, audioFileType, numberOfBitsPerSamplePoint);
+	} catch (MelderError) {
+		Melder_throw (me, U" & ", kernel, U": not convolved to ", file, U".");
 	}
 }
 
@@ -1,6 +1,6 @@
 /* Sound_and_Spectrum.h
  *
- * Copyright (C) 1992-2005,2007,2009,2011,2012,2015,2016,2018 Paul Boersma
+ * Copyright (C) 1992-2005,2007,2009,2011,2012,2015,2016,2018,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,6 +19,7 @@
 #include "Sound.h"
 #include "Spectrum.h"
 Thing_declare (Interpreter);
+Thing_declare (LongSound);
 
 autoSpectrum Sound_to_Spectrum_at (Sound me, double tim, double windowDuration, int windowType);
 
@@ -30,5 +31,52 @@ autoSpectrum Spectrum_lpcSmoothing (Spectrum me, int numberOfPeaks, double preem
 autoSound Sound_filter_passHannBand (Sound me, double fmin, double fmax, double smooth);
 autoSound Sound_filter_stopHannBand (Sound me, double fmin, double fmax, double smooth);
 autoSound Sound_filter_formula (Sound me, conststring32 formula, Interpreter interpreter);
+/*
+	These three filter the whole sound at once in the frequency domain,
+	so the result of each sample depends on the whole sound (through the zero-padded length, for instance).
+*/
+
+autoSpectrum Sound_to_Spectrum_unity (Sound me);
+/*
+	A Spectrum with the frequencies that Sound_to_Spectrum (me, true) would have, all with the value 1;
+	after filters such as Spectrum_passHannBand have been applied to it,
+	its real part is the gain of those filters, ready for Sound_filterWithGain_inplace.
+*/
+void Sound_filterWithGain_inplace (Sound me, integer fromChannel, integer toChannel, constVEC const& gain);
+/*
+	Multiply the spectrum of each channel from `fromChannel` to `toChannel` by the real `gain`,
+	in place, in parallel over the channels, and with a single Fourier table for all channels.
+*/
+
+void convolve_overlapSave_MAT_out (MATVU const& target, constMATVU const& signal, constMATVU const& kernels, integer lag);
+/*
+	target [ichan] [i] = sum (k = 1 .. kernels.ncol) kernel [k] * signal [i + lag + 1 - k],
+	where `signal` and `kernel` are the rows `ichan` of `signal` and `kernels` (or their only row),
+	and the signal is zero outside 1 .. signal.ncol;
+	so `lag` = 0 gives the first target.ncol samples of the full convolution,
+	and `lag` = c - 1 centres the kernel at its sample c.
+	Computed with overlap-save, in blocks whose Fourier transforms fit in the cache,
+	in parallel over channels and blocks.
+*/
+
+void LongSound_filter_passHannBand_toAudioFile (LongSound me, double fmin, double fmax, double smooth,
+	MelderFile file, int audioFileType, int numberOfBitsPerSamplePoint);
+void LongSound_filter_stopHannBand_toAudioFile (LongSound me, double fmin, double fmax, double smooth,
+	MelderFile file, int audioFileType, int numberOfBitsPerSamplePoint);
+void LongSound_filter_formula_toAudioFile (LongSound me, conststring32 formula, Interpreter interpreter,
+	MelderFile file, int audioFileType, int numberOfBitsPerSamplePoint);
+/*
+	The same filters as above, but streaming, so that the sound never has to be in memory as a whole.
+	The filter is applied as a convolution with its impulse response, which is computed (as the above would do)
+	from a Spectrum with a resolution of 1 Hz, or 1/64 of the smoothing of the Hann bands if that is finer,
+	so that the results are those of the whole-sound filters except near the edges of the sound,
+	where the whole-sound filters spill over from the other edge.
+*/
+
+void LongSound_Sound_convolve_toAudioFile (LongSound me, constSound kernel,
+	MelderFile file, int audioFileType, int numberOfBitsPerSamplePoint);
+/*
+	Streaming version of Sounds_convolve (me, kernel, kSounds_convolve_scaling::SUM, kSounds_convolve_signalOutsideTimeDomain::ZERO).
+*/
 
 /* End of file Sound_and_Spectrum.h */
@@ -1,6 +1,6 @@
 /* Sound_to_Intensity.cpp
  *
- * Copyright (C) 1992-2012,2014-2020,2023 Paul Boersma
+ * Copyright (C) 1992-2012,2014-2020,2023,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -29,9 +29,150 @@
  * pb 2008/01/19 double
  * pb 2011/03/04 C++
  * pb 2011/03/28 C++
+ * pb 2026/10/18 multithreading; Fourier convolution for large overlaps
  */
 
 #include "Sound_to_Intensity.h"
+#include "Sound_and_Spectrum.h"
+
+static double intensity_in_dB_re_hearingThreshold (double intensity_in_Pa2) {
+	constexpr double hearingThreshold_in_Pa = 2.0e-5;
+	constexpr double hearingThreshold_in_Pa2 = sqr (hearingThreshold_in_Pa);
+	const double intensity_re_hearingThreshold = intensity_in_Pa2 / hearingThreshold_in_Pa2;
+	return intensity_re_hearingThreshold < 1.0e-30 ? -300.0 : 10.0 * log10 (intensity_re_hearingThreshold);
+}
+
+/*
+	The samples that frame `iframe` looks at, clipped to the sound.
+*/
+static void getWindowedSamples (Sound me, Intensity thee, integer iframe, integer halfWindowSamples,
+	integer *out_soundCentreSampleNumber, integer *out_leftSample, integer *out_rightSample)
+{
+	const double midTime = Sampled_indexToX (thee, iframe);
+	const integer soundCentreSampleNumber = Sampled_xToNearestIndex (me, midTime);   // time accuracy is half a sampling period
+
+	integer leftSample = soundCentreSampleNumber - halfWindowSamples;
+	integer rightSample = soundCentreSampleNumber + halfWindowSamples;
+	/*
+		Catch some edge cases, which are uncommon because Sampled_shortTermAnalysis() filtered out most problems.
+	*/
+	Melder_clipLeft (1_integer, & leftSample);
+	Melder_clipRight (& rightSample, my nx);
+	Melder_require (rightSample >= leftSample,
+		U"Unexpected edge case: right sample (", rightSample, U") less than left sample (", leftSample, U").");
+	*out_soundCentreSampleNumber = soundCentreSampleNumber;
+	*out_leftSample = leftSample;
+	*out_rightSample = rightSample;
+}
+
+/*
+	Each frame as a dot product of the squared signal with the window, in parallel over the frames.
+*/
+static void Sound_into_Intensity_direct (Sound me, Intensity thee, constVEC const& window, bool subtractMeanPressure) {
+	const integer windowNumberOfSamples = window.size, halfWindowSamples = windowNumberOfSamples / 2;
+	const integer windowCentreSampleNumber = halfWindowSamples + 1;
+	const integer thresholdNumberOfFramesPerThread = 1 + 100'000 / (windowNumberOfSamples * my ny);
+	MelderThread_PARALLEL (thy nx, thresholdNumberOfFramesPerThread) {
+		autoVEC amplitude = zero_VEC (windowNumberOfSamples);
+		MelderThread_FOR (iframe) {
+			integer soundCentreSampleNumber, leftSample, rightSample;
+			getWindowedSamples (me, thee, iframe, halfWindowSamples, & soundCentreSampleNumber, & leftSample, & rightSample);
+			const integer windowFromSoundOffset = windowCentreSampleNumber - soundCentreSampleNumber;
+			VEC amplitudePart = amplitude.part (windowFromSoundOffset + leftSample, windowFromSoundOffset + rightSample);
+			constVEC windowPart = window.part (windowFromSoundOffset + leftSample, windowFromSoundOffset + rightSample);
+			longdouble sumxw = 0.0, sumw = 0.0;
+			for (integer ichan = 1; ichan <= my ny; ichan ++) {
+				amplitudePart  <<=  my z [ichan].part (leftSample, rightSample);
+				if (subtractMeanPressure)
+					centre_VEC_inout (amplitudePart);
+				for (integer isamp = 1; isamp <= amplitudePart.size; isamp ++) {
+					sumxw += sqr (amplitudePart [isamp]) * windowPart [isamp];
+					sumw += windowPart [isamp];
+				}
+			}
+			thy z [1] [iframe] = intensity_in_dB_re_hearingThreshold (double (sumxw / sumw));
+		}
+	} MelderThread_ENDPARALLEL
+}
+
+/*
+	The same as a convolution of the squared signal with the window, evaluated at the frame centres,
+	so that the cost no longer grows with the overlap of the frames.
+	Subtracting the local mean m works through the identity
+		sum ((x - m)^2 w) = sum (x^2 w) - 2 m sum (x w) + m^2 sum (w),
+	so that the signal itself is convolved with the window as well.
+	The frames are computed in chunks, in parallel; each chunk needs a single transform per convolved signal.
+*/
+static void Sound_into_Intensity_fourier (Sound me, Intensity thee, constVEC const& window, bool subtractMeanPressure) {
+	const integer windowNumberOfSamples = window.size, halfWindowSamples = windowNumberOfSamples / 2;
+	const integer windowCentreSampleNumber = halfWindowSamples + 1;
+	autoVEC windowSums = raw_VEC (windowNumberOfSamples + 1);   // windowSums [i + 1] = sum (window [1 .. i])
+	windowSums [1] = 0.0;
+	for (integer i = 1; i <= windowNumberOfSamples; i ++)
+		windowSums [i + 1] = windowSums [i] + window [i];
+	const constMAT kernel (& window [1], 1, windowNumberOfSamples);
+	const integer transformSize = Melder_iroundUpToPowerOfTwo (std::max (4 * windowNumberOfSamples, 16384_integer));
+	const integer maximumNumberOfCentresPerChunk = transformSize - windowNumberOfSamples + 1;
+	const double framesPerSample = my dx / thy dx;
+	const integer numberOfFramesPerChunk = 1 + Melder_ifloor ((maximumNumberOfCentresPerChunk - 3) * framesPerSample);
+	const integer numberOfChunks = (thy nx - 1) / numberOfFramesPerChunk + 1;
+	const integer numberOfConvolvedSignals = ( subtractMeanPressure ? 2 * my ny : my ny );
+	MelderThread_PARALLEL (numberOfChunks, 1) {
+		MelderThread_FOR (ichunk) {
+			const integer firstFrame = (ichunk - 1) * numberOfFramesPerChunk + 1;
+			const integer lastFrame = std::min (firstFrame + numberOfFramesPerChunk - 1, thy nx);
+			integer firstCentre, lastCentre, dummyLeft, dummyRight;
+			getWindowedSamples (me, thee, firstFrame, halfWindowSamples, & firstCentre, & dummyLeft, & dummyRight);
+			getWindowedSamples (me, thee, lastFrame, halfWindowSamples, & lastCentre, & dummyLeft, & dummyRight);
+			/*
+				signals [ichan] [j] is the square of sound sample firstSample + j - 1 (zero outside the sound),
+				and signals [my ny + ichan] [j] is that sample itself;
+				cumulative [irow] [j + 1] is the sum of signals [irow] [1 .. j].
+			*/
+			const integer firstSample = firstCentre - halfWindowSamples, lastSample = lastCentre + halfWindowSamples;
+			const integer numberOfSamples = lastSample - firstSample + 1, numberOfCentres = lastCentre - firstCentre + 1;
+			autoMAT signals = zero_MAT (numberOfConvolvedSignals, numberOfSamples);
+			autoMAT cumulative = raw_MAT (numberOfConvolvedSignals, numberOfSamples + 1);
+			const integer firstInside = std::max (firstSample, 1_integer), lastInside = std::min (lastSample, my nx);
+			for (integer ichan = 1; ichan <= my ny; ichan ++) {
+				for (integer isamp = firstInside; isamp <= lastInside; isamp ++) {
+					const double value = my z [ichan] [isamp];
+					signals [ichan] [isamp - firstSample + 1] = sqr (value);
+					if (subtractMeanPressure)
+						signals [my ny + ichan] [isamp - firstSample + 1] = value;
+				}
+			}
+			for (integer irow = 1; irow <= numberOfConvolvedSignals; irow ++) {
+				cumulative [irow] [1] = 0.0;
+				for (integer j = 1; j <= numberOfSamples; j ++)
+					cumulative [irow] [j + 1] = cumulative [irow] [j] + signals [irow] [j];
+			}
+			autoMAT convolutions = raw_MAT (numberOfConvolvedSignals, numberOfCentres);
+			convolve_overlapSave_MAT_out (convolutions.get(), signals.get(), kernel, windowNumberOfSamples - 1);
+			for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
+				integer soundCentreSampleNumber, leftSample, rightSample;
+				getWindowedSamples (me, thee, iframe, halfWindowSamples, & soundCentreSampleNumber, & leftSample, & rightSample);
+				const integer windowFromSoundOffset = windowCentreSampleNumber - soundCentreSampleNumber;
+				const double sumw = windowSums [windowFromSoundOffset + rightSample + 1] - windowSums [windowFromSoundOffset + leftSample];
+				const integer icentre = soundCentreSampleNumber - firstCentre + 1;
+				const integer left = leftSample - firstSample + 1, right = rightSample - firstSample + 1;
+				double sumxw = 0.0;
+				for (integer ichan = 1; ichan <= my ny; ichan ++) {
+					const double sumx2 = cumulative [ichan] [right + 1] - cumulative [ichan] [left];
+					if (sumx2 == 0.0)
+						continue;   // digital silence (this is exact): nothing to add, not even rounding errors
+					double sumx2w = convolutions [ichan] [icentre];
+					if (subtractMeanPressure) {
+						const double mean = (cumulative [my ny + ichan] [right + 1] - cumulative [my ny + ichan] [left]) / (right - left + 1);
+						sumx2w += mean * (mean * sumw - 2.0 * convolutions [my ny + ichan] [icentre]);
+					}
+					sumxw += std::max (sumx2w, 0.0);   // rounding could make it slightly negative
+				}
+				thy z [1] [iframe] = intensity_in_dB_re_hearingThreshold (sumxw / (my ny * sumw));
+			}
+		}
+	} MelderThread_ENDPARALLEL
+}
 
 static autoIntensity Sound_to_Intensity_ (Sound me, double pitchFloor, double timeStep, bool subtractMeanPressure) {
 	try {
@@ -64,7 +205,6 @@ static autoIntensity Sound_to_Intensity_ (Sound me, double pitchFloor, double ti
 		const double halfWindowDuration = 0.5 * physicalWindowDuration;
 		const integer halfWindowSamples = Melder_ifloor (halfWindowDuration / my dx);
 		const integer windowNumberOfSamples = 2 * halfWindowSamples + 1;
-		autoVEC amplitude = zero_VEC (windowNumberOfSamples);
 		autoVEC window = zero_VEC (windowNumberOfSamples);
 		const integer windowCentreSampleNumber = halfWindowSamples + 1;
 
@@ -85,41 +225,19 @@ static autoIntensity Sound_to_Intensity_ (Sound me, double pitchFloor, double ti
 				U"i.e. at least ", physicalWindowDuration, U" s, instead of ", physicalSoundDuration, U" s.");
 		}
 		autoIntensity thee = Intensity_create (my xmin, my xmax, numberOfFrames, timeStep, thyFirstTime);
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const double midTime = Sampled_indexToX (thee.get(), iframe);
-			const integer soundCentreSampleNumber = Sampled_xToNearestIndex (me, midTime);   // time accuracy is half a sampling period
-
-			integer leftSample = soundCentreSampleNumber - halfWindowSamples;
-			integer rightSample = soundCentreSampleNumber + halfWindowSamples;
-			/*
-				Catch some edge cases, which are uncommon because Sampled_shortTermAnalysis() filtered out most problems.
-			*/
-			Melder_clipLeft (1_integer, & leftSample);
-			Melder_clipRight (& rightSample, my nx);
-			Melder_require (rightSample >= leftSample,
-				U"Unexpected edge case: right sample (", rightSample, U") less than left sample (", leftSample, U").");
-
-			const integer windowFromSoundOffset = windowCentreSampleNumber - soundCentreSampleNumber;
-			VEC amplitudePart = amplitude.part (windowFromSoundOffset + leftSample, windowFromSoundOffset + rightSample);
-			constVEC windowPart = window.part (windowFromSoundOffset + leftSample, windowFromSoundOffset + rightSample);
-			longdouble sumxw = 0.0, sumw = 0.0;
-			for (integer ichan = 1; ichan <= my ny; ichan ++) {
-				amplitudePart  <<=  my z [ichan].part (leftSample, rightSample);
-				if (subtractMeanPressure)
-					centre_VEC_inout (amplitudePart);
-				for (integer isamp = 1; isamp <= amplitudePart.size; isamp ++) {
-					sumxw += sqr (amplitudePart [isamp]) * windowPart [isamp];
-					sumw += windowPart [isamp];
-				}
-			}
-			const double intensity_in_Pa2 = double (sumxw / sumw);
-			constexpr double hearingThreshold_in_Pa = 2.0e-5;
-			constexpr double hearingThreshold_in_Pa2 = sqr (hearingThreshold_in_Pa);
-			const double intensity_re_hearingThreshold = intensity_in_Pa2 / hearingThreshold_in_Pa2;
-			const double intensity_in_dB_re_hearingThreshold = ( intensity_re_hearingThreshold < 1.0e-30 ? -300.0 :
-					10.0 * log10 (intensity_re_hearingThreshold) );
-			thy z [1] [iframe] = intensity_in_dB_re_hearingThreshold;
-		}
+		/*
+			The direct computation costs some `windowNumberOfSamples` operations per frame,
+			the Fourier computation a fixed number of operations per sample;
+			so the Fourier computation wins if the frames overlap a lot, i.e. if the time step is small.
+			The break-even point turns out to lie at an overlap of 10 to 12 frames per window,
+			so the standard time step (8 frames per window) still uses the direct computation.
+		*/
+		const double numberOfFramesPerWindow = windowNumberOfSamples * my dx / timeStep;
+		const bool useFourier = ( Melder_debug == 62 ? false : Melder_debug == 63 ? true : numberOfFramesPerWindow > 12.0 );
+		if (useFourier)
+			Sound_into_Intensity_fourier (me, thee.get(), window.get(), subtractMeanPressure);
+		else
+			Sound_into_Intensity_direct (me, thee.get(), window.get(), subtractMeanPressure);
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": intensity analysis not performed.");
@@ -1,6 +1,6 @@
 /* Sound_to_Pitch.cpp
  *
- * Copyright (C) 1992-2005,2007-2012,2014-2020,2023-2025 Paul Boersma
+ * Copyright (C) 1992-2005,2007-2012,2014-2020,2023-2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -43,7 +43,7 @@
 
 static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 	double pitchFloor, int maxnCandidates, int method, double voicingThreshold, double octaveCost,
-	NUMFourierTable fftTable, double dt_window, integer nsamp_window, integer halfnsamp_window,
+	constNUMFourierTable fftTable, double dt_window, integer nsamp_window, integer halfnsamp_window,
 	integer maximumLag, integer nsampFFT, integer nsamp_period, integer halfnsamp_period,
 	integer brent_ixmax, integer brent_depth, double globalPeak,
 	MAT const& frame, VEC const& ac, VEC const& window, VEC const& windowR,
@@ -145,8 +145,8 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		*/
 		for (integer i = 1; i <= nsampFFT; i ++)
 			ac [i] = 0.0;
+		NUMfft_forward_batch (fftTable, frame);   // complex spectra of all channels
 		for (integer channel = 1; channel <= my ny; channel ++) {
-			NUMfft_forward (fftTable, VEC (& frame [channel] [1], fftTable->n));   // complex spectrum
 			ac [1] += frame [channel] [1] * frame [channel] [1];   // DC component
 			for (integer i = 2; i < nsampFFT; i += 2)
 				ac [i] += frame [channel] [i] * frame [channel] [i] + frame [channel] [i+1] * frame [channel] [i+1];   // power spectrum
@@ -397,7 +397,7 @@ autoPitch Sound_to_Pitch_any (Sound me,
 			*/
 			windowR. resize (nsampFFT);
 			window. resize (nsamp_window);
-			autoNUMFourierTable fftTable = NUMFourierTable_create (nsampFFT);
+			sharedNUMFourierTable fftTable = NUMFourierTable_getShared (nsampFFT);
 
 			/*
 				A Gaussian or Hanning window is applied against phase effects.
@@ -440,12 +440,12 @@ autoPitch Sound_to_Pitch_any (Sound me,
 
 		MelderThread_PARALLEL (numberOfFrames, 5) {
 			autoMAT frame;
-			autoNUMFourierTable fftTable;
+			sharedNUMFourierTable fftTable;
 			autoVEC ac;
 			if (method >= FCC_NORMAL) {   // cross-correlation
 				frame = zero_MAT (my ny, nsamp_window);
 			} else {   // autocorrelation
-				fftTable = NUMFourierTable_create (nsampFFT);
+				fftTable = NUMFourierTable_getShared (nsampFFT);
 				frame = zero_MAT (my ny, nsampFFT);
 				ac = zero_VEC (nsampFFT);
 			}
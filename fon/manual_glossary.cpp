@@ -1,6 +1,6 @@
 /* manual_glossary.cpp
  *
- * Copyright (C) 1992-2008,2010,2011,2014-2017,2020-2025 Paul Boersma
+ * Copyright (C) 1992-2008,2010,2011,2014-2017,2020-2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -105,12 +105,13 @@ MAN_BEGIN (U"end time", U"ppgb", 20060714)
 INTRO (U"- the end of the @@time domain@ (see there).")
 MAN_END
 
-MAN_BEGIN (U"Fast Fourier Transform", U"ppgb", 20231115)  // 20041123, 2024
+MAN_BEGIN (U"Fast Fourier Transform", U"ppgb", 20261018)  // 20041123, 2024
 INTRO (U"An algorithm for fast computation of the Fourier transform of a sampled signal. "
-	"It involves increasing the number of samples %N to the next-highest power of two, "
-	"and the computation time scales as %N log %N.")
+	"The computation time scales as %N log %N, where %N is the number of samples. "
+	"Traditionally, this involved increasing %N to the next-highest power of two; "
+	"since 2026, Praat handles any %N directly, with Bluestein's algorithm if %N has large prime factors.")
 NORMAL (U"In Praat, the Fast Fourier Transform is used:")
-LIST_ITEM (U"1. For the Fourier transform of an entire sound: @@Sound: To Spectrum...@ with #yes for the #Fast setting, "
+LIST_ITEM (U"1. For the Fourier transform of an entire sound: @@Sound: To Spectrum...@ (with #yes or #no for the #Fast setting) "
 	"and @@Spectrum: To Sound@.")
 LIST_ITEM (U"2. For the Fourier transform of consecutive frames in a sound. See @@Sound: To Spectrogram...@.")
 LIST_ITEM (U"3. For the fast computation of correlations, e.g. in @@Sound: To Pitch (raw autocorrelation)...@.")
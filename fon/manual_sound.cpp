@@ -1,6 +1,6 @@
 /* manual_sound.cpp
  *
- * Copyright (C) 1992-2008,2010-2012,2014-2025 Paul Boersma
+ * Copyright (C) 1992-2008,2010-2012,2014-2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -1730,7 +1730,10 @@ with a depth equal to #Precision.
 For higher #Precision, the algorithm is slower but more accurate.
 
 If ##Sampling frequency# is less than the sampling frequency of the selected sound,
-an anti-aliasing low-pass filtering is performed prior to resampling.
+the sinc function is stretched so that it cuts off at the new Nyquist frequency,
+which makes the interpolation an anti-aliasing low-pass filter as well;
+#Precision is then the depth measured in new samples. Samples outside the time domain of the sound count as zero.
+(Before Praat 7.0.02, the anti-aliasing filter was applied separately, with a Fourier transform of the whole sound.)
 
 Behaviour
 =========
@@ -393,6 +393,18 @@ NORMAL (U"The length of the sound file is limited to 2 gigabytes, which is 3 hou
 	"or 12 hours 16-bit mono sampled at 22050 Hz.")
 MAN_END
 
+MAN_BEGIN (U"LongSound: Filter (pass Hann band) to audio file...", U"ppgb", 20261018)
+INTRO (U"A command to filter the selected @LongSound object into a new sound file, "
+	"without ever reading the whole sound into memory.")
+NORMAL (U"The settings are those of @@Sound: Filter (pass Hann band)...@, plus the name and type of the audio file. "
+	"The filter is applied as a convolution with its impulse response, "
+	"one block of samples at a time, so that the result equals that of @@Sound: Filter (pass Hann band)...@ "
+	"except very close to the beginning and the end of the sound.")
+NORMAL (U"The same is true for ##Filter (stop Hann band) to audio file...# and ##Filter (formula) to audio file...#. "
+	"With ##LongSound & Sound: Convolve to audio file...#, you convolve a LongSound with a short Sound "
+	"(e.g. an impulse response); the result is that of @@Sounds: Convolve...@ with #sum scaling.")
+MAN_END
+
 MAN_BEGIN (U"LongSound: To TextGrid...", U"ppgb", 19980730)
 INTRO (U"A command to create a @TextGrid without any labels, copying the time domain from the selected @LongSound.")
 NORMAL (U"See @@Sound: To TextGrid...@ for the settings.")
@@ -1,6 +1,6 @@
 /* manual_spectrum.cpp
  *
- * Copyright (C) 1992-2008,2010-2012,2014-2017,2019-2023,2025 Paul Boersma
+ * Copyright (C) 1992-2008,2010-2012,2014-2017,2019-2023,2025,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -454,13 +454,15 @@ INTRO (U"A command available in the #Spectrum menu if you select one or more @So
 NORMAL (U"The analysis method is described in @@Boersma & Kovacic (2006)@.")
 MAN_END
 
-MAN_BEGIN (U"Sound: To Spectrum...", U"ppgb", 20041123)
+MAN_BEGIN (U"Sound: To Spectrum...", U"ppgb", 20261018)
 INTRO (U"A command that appears in the #Spectrum menu if you select one or more @Sound objects. "
 	"It turns the selected Sound into a @Spectrum by an over-all spectral analysis, a %%Fourier transform%.")
 ENTRY (U"Setting")
 TERM (U"##Fast")
 DEFINITION (U"determines whether zeroes are appended to the sound such that the number of samples is a power of two. "
-	"This can appreciably speed up the Fourier transform.")
+	"This used to speed up the Fourier transform appreciably, but since 2026 Praat transforms any number of samples "
+	"in a time of the order of %N log %N, so that switching this off costs little time "
+	"(and gives you a Spectrum whose frequency step is exactly 1 divided by the duration of the Sound).")
 ENTRY (U"Mathematical procedure")
 NORMAL (U"For the Fourier transform, the Praat-defined @@time domain@ of the @Sound is ignored. "
 	"Instead, its time domain is considered to run from %t=0 to %t=%T, "
@@ -1,6 +1,6 @@
 /* manual_tutorials.cpp
  *
- * Copyright (C) 1992-2025 Paul Boersma
+ * Copyright (C) 1992-2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -1660,6 +1660,7 @@ NORMAL (U"If no object is selected, the #Save menu is empty. "
 LIST_ITEM (U"• @@Save as text file...")
 LIST_ITEM (U"• @@Save as short text file...")
 LIST_ITEM (U"• @@Save as binary file...")
+LIST_ITEM (U"• @@Save as mappable binary file...")
 ENTRY (U"Dynamic commands")
 NORMAL (U"Depending on the type of the selected object, the following commands may be available "
 	"in the #Save menu:")
@@ -1679,6 +1680,25 @@ NORMAL (U"These files are in a device-independent binary format, "
 	"and can be written and read on any machine.")
 MAN_END
 
+MAN_BEGIN (U"Save as mappable binary file...", U"ppgb", 20261018)
+INTRO (U"One of the commands in the @@Save menu@.")
+ENTRY (U"Availability")
+NORMAL (U"You can choose this command after selecting one or more @objects.")
+ENTRY (U"Behaviour")
+NORMAL (U"The Objects window will ask you for a file name. "
+	"After you click OK, the objects will be written to a binary file on disk.")
+ENTRY (U"Usage")
+NORMAL (U"The file can be read again with @@Read from file...@ (in Praat version 7.0.02 or later). "
+	"On a computer with the same byte order, the sound samples, matrix cells and spectrogram values "
+	"are not copied into memory when the file is read; they are read from disk only when they are used, "
+	"and Praat sessions that read the same file share its memory. "
+	"This makes large files open almost instantly.")
+ENTRY (U"File format")
+NORMAL (U"This format is the same as the one of @@Save as binary file...@, "
+	"except that the real-valued arrays of numbers are stored in the byte order of the computer that wrote the file. "
+	"The file can still be read on computers with a different byte order, but more slowly.")
+MAN_END
+
 MAN_BEGIN (U"Save as short text file...", U"ppgb", 20110129)
 INTRO (U"One of the commands in the @@Save menu@.")
 ENTRY (U"Availability")
@@ -132,6 +132,53 @@ DO
 	SAVE_ONE_BY_NAME_END
 }
 
+FORM (SAVE_ONE__LongSound_filter_passHannBand_toAudioFile, U"LongSound: Filter (pass Hann band) to audio file", U"LongSound: Filter (pass Hann band) to audio file...") {
+	OUTFILE (audioFileName, U"Audio file", U"")
+	CHOICE (type, U"Type", 3)
+	{ int i; for (i = 1; i <= Melder_NUMBER_OF_AUDIO_FILE_TYPES; i ++) {
+		OPTION (Melder_audioFileTypeString (i))
+	}}
+	REAL (fromFrequency, U"From frequency (Hz)", U"500.0")
+	REAL (toFrequency, U"To frequency (Hz)", U"1000.0")
+	POSITIVE (smoothing, U"Smoothing (Hz)", U"100.0")
+	OK
+DO
+	SAVE_ONE_BY_NAME (LongSound, audioFileName, U"save the filtered LongSound object to the audio file")
+		LongSound_filter_passHannBand_toAudioFile (me, fromFrequency, toFrequency, smoothing, & file, type, 16);
+	SAVE_ONE_BY_NAME_END
+}
+
+FORM (SAVE_ONE__LongSound_filter_stopHannBand_toAudioFile, U"LongSound: Filter (stop Hann band) to audio file", U"LongSound: Filter (pass Hann band) to audio file...") {
+	OUTFILE (audioFileName, U"Audio file", U"")
+	CHOICE (type, U"Type", 3)
+	{ int i; for (i = 1; i <= Melder_NUMBER_OF_AUDIO_FILE_TYPES; i ++) {
+		OPTION (Melder_audioFileTypeString (i))
+	}}
+	REAL (fromFrequency, U"From frequency (Hz)", U"500.0")
+	REAL (toFrequency, U"To frequency (Hz)", U"1000.0")
+	POSITIVE (smoothing, U"Smoothing (Hz)", U"100.0")
+	OK
+DO
+	SAVE_ONE_BY_NAME (LongSound, audioFileName, U"save the filtered LongSound object to the audio file")
+		LongSound_filter_stopHannBand_toAudioFile (me, fromFrequency, toFrequency, smoothing, & file, type, 16);
+	SAVE_ONE_BY_NAME_END
+}
+
+FORM (SAVE_ONE__LongSound_filter_formula_toAudioFile, U"LongSound: Filter (formula) to audio file", U"LongSound: Filter (pass Hann band) to audio file...") {
+	OUTFILE (audioFileName, U"Audio file", U"")
+	CHOICE (type, U"Type", 3)
+	{ int i; for (i = 1; i <= Melder_NUMBER_OF_AUDIO_FILE_TYPES; i ++) {
+		OPTION (Melder_audioFileTypeString (i))
+	}}
+	COMMENT (U"Frequency-domain filtering with a formula: x is frequency in hertz")
+	FORMULA (formula, U"Formula", U"if x<500 or x>1000 then 0 else self fi; rectangular band filter")
+	OK
+DO
+	SAVE_ONE_BY_NAME (LongSound, audioFileName, U"save the filtered LongSound object to the audio file")
+		LongSound_filter_formula_toAudioFile (me, formula, interpreter, & file, type, 16);
+	SAVE_ONE_BY_NAME_END
+}
+
 FORM (NEW_LongSound_to_TextGrid, U"LongSound: To TextGrid...", U"LongSound: To TextGrid...") {
 	SENTENCE (tierNames, U"Tier names", U"Mary John bell")
 	SENTENCE (pointTiers, U"Point tiers", U"bell")
@@ -273,6 +320,19 @@ DO
 
 /********** LONGSOUND & SOUND **********/
 
+FORM (SAVE_ONE_AND_ONE__LongSound_Sound_convolve_toAudioFile, U"LongSound & Sound: Convolve to audio file", U"LongSound & Sound: Convolve to audio file...") {
+	OUTFILE (audioFileName, U"Audio file", U"")
+	CHOICE (type, U"Type", 3)
+	{ int i; for (i = 1; i <= Melder_NUMBER_OF_AUDIO_FILE_TYPES; i ++) {
+		OPTION (Melder_audioFileTypeString (i))
+	}}
+	OK
+DO
+	SAVE_ONE_AND_ONE_BY_NAME (LongSound, Sound, audioFileName, U"save the convolution of the selected LongSound and Sound objects to the audio file")
+		LongSound_Sound_convolve_toAudioFile (me, you, & file, type, 16);
+	SAVE_ONE_AND_ONE_BY_NAME_END
+}
+
 FORM_SAVE (SAVE_ALL__LongSound_Sound_saveAsAifcFile, U"Save as AIFC file", nullptr, U"aifc") {
 	SAVE_ALL_LISTED (SampledXY, SoundAndLongSoundList, U"save the selected (Long)Sound object(s) to the AIFC file")
 		LongSound_concatenate (list.get(), file, Melder_AIFC, 16);
@@ -2381,6 +2441,13 @@ void praat_Sound_init () {
 			nullptr, 0, SAVE_ONE__LongSound_saveRightChannelAsFlacFile);
 	praat_addAction1 (classLongSound, 1, U"Save part as audio file... || Write part to audio file...",
 			nullptr, 0, SAVE_ONE__LongSound_savePartAsAudioFile);
+	praat_addAction1 (classLongSound, 0, U"Filter -", nullptr, 0, nullptr);
+		praat_addAction1 (classLongSound, 1, U"Filter (pass Hann band) to audio file...", nullptr, 1,
+				SAVE_ONE__LongSound_filter_passHannBand_toAudioFile);
+		praat_addAction1 (classLongSound, 1, U"Filter (stop Hann band) to audio file...", nullptr, 1,
+				SAVE_ONE__LongSound_filter_stopHannBand_toAudioFile);
+		praat_addAction1 (classLongSound, 1, U"Filter (formula) to audio file...", nullptr, 1,
+				SAVE_ONE__LongSound_filter_formula_toAudioFile);
 
 	praat_addAction1 (classSound, 0, U"Save as WAV file... || Write to WAV file...",
 			nullptr, 0, SAVE_ALL__Sound_saveAsWavFile);   // alternative COMPATIBILITY <= 2011
@@ -2680,6 +2747,8 @@ void praat_Sound_init () {
 		praat_addAction1 (classSound, 2, U"To ParamCurve", nullptr, 1,
 				CONVERT_TWO_TO_ONE__Sounds_to_ParamCurve);
 
+	praat_addAction2 (classLongSound, 1, classSound, 1, U"Convolve to audio file...",
+			nullptr, 0, SAVE_ONE_AND_ONE__LongSound_Sound_convolve_toAudioFile);
 	praat_addAction2 (classLongSound, 0, classSound, 0, U"Save as WAV file... || Write to WAV file...",
 			nullptr, 0, SAVE_ALL__LongSound_Sound_saveAsWavFile);   // alternative COMPATIBILITY <= 2011
 	praat_addAction2 (classLongSound, 0, classSound, 0, U"Save as AIFF file... || Write to AIFF file...",
@@ -1,6 +1,6 @@
 /* MelderThread.cpp
  *
- * Copyright (C) 2025 Paul Boersma
+ * Copyright (C) 2025,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,8 +17,8 @@
  */
 
 #include "melder.h"
-#include <vector>
 #include <thread>
+#include <condition_variable>
 
 integer MelderThread_getNumberOfProcessors () {
 	//return 1;   // un-comment-out to force single-threading
@@ -35,52 +35,295 @@ integer Melder_thisThread_getUniqueID () {
 	return thisThread_uniqueID;
 }
 
-void MelderThread_run (
-	std::atomic <bool> *p_errorFlag,
-	const integer numberOfElements,
-	const integer thresholdNumberOfElementsPerThread,
-	std::function <void (integer threadNumber, integer firstElement, integer lastElement)> const& threadFunction
-) {
-	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfElements, thresholdNumberOfElementsPerThread);
-	if (numberOfThreads == 1) {
-		threadFunction (0, 1, numberOfElements);
-	} else {
-		const integer numberOfExtraThreads = numberOfThreads - 1;   // at least 1
+/*
+	The thread pool.
+
+	Spawning a std::thread costs tens of microseconds on Linux and much more on Windows and the Mac,
+	so short analyses (e.g. in a script that loops over thousands of intervals) used to be
+	dominated by thread creation. We therefore start the threads only once,
+	at the first parallel job, and let them sleep between jobs.
+
+	Within a job, each thread owns a contiguous range of elements ("deque"),
+	from whose front it takes small chunks. A thread that has finished its own range
+	steals the back half of the range of another thread. In this way, frames that take very different
+	amounts of time (voiced versus silent pitch frames, say) no longer leave processors idle.
+
+	The contract with the thread function remains as it was: the thread function is called once
+	for each thread, with that thread's number (which is also the thread's NUMrandom channel)
+	and the initial range of that thread. Thread functions that loop with MelderThread_FOR
+	take part in work stealing; thread functions that loop from firstElement to lastElement themselves
+	simply do their own range.
+*/
+
+namespace {
+
+struct MelderThread_Range {
+	std::mutex mutex;
+	integer front, back;   // the elements still to be done are front .. back
+};
+
+struct MelderThread_WorkerStatistics {
+	integer numberOfElements = 0, numberOfChunks = 0, numberOfSteals = 0;
+	double busyTime = 0.0;
+};
+
+struct MelderThread_Job {
+	std::function <void (integer threadNumber, integer firstElement, integer lastElement)> const *threadFunction;
+	std::atomic <bool> *p_errorFlag;
+	integer numberOfThreads, numberOfElements, chunkSize;
+	std::unique_ptr <MelderThread_Range []> ranges;   // base-0, because std::mutex cannot live in an autovector
+	std::unique_ptr <MelderThread_WorkerStatistics []> statistics;   // base-0
+	std::atomic <integer> numberOfElementsTaken { 0 };
+
+	MelderThread_Job (std::atomic <bool> *p_errorFlag_, integer numberOfThreads_, integer numberOfElements_,
+		std::function <void (integer threadNumber, integer firstElement, integer lastElement)> const& threadFunction_)
+	:
+		threadFunction (& threadFunction_),
+		p_errorFlag (p_errorFlag_),
+		numberOfThreads (numberOfThreads_),
+		numberOfElements (numberOfElements_),
+		ranges (new MelderThread_Range [uinteger (numberOfThreads_)]),
+		statistics (new MelderThread_WorkerStatistics [uinteger (numberOfThreads_)])
+	{
+		/*
+			Chunks should be small enough to balance the load,
+			but large enough that the owner seldom has to lock its range.
+		*/
+		chunkSize = Melder_clippedLeft (1_integer, numberOfElements / (16 * numberOfThreads));
+		const integer base = numberOfElements / numberOfThreads;
+		const integer remainder = numberOfElements % numberOfThreads;
+		integer firstElement = 1;
+		for (integer ithread = 0; ithread < numberOfThreads; ithread ++) {
+			const integer lastElement = firstElement + base - 1 + ( ithread < remainder );
+			ranges [uinteger (ithread)]. front = firstElement;
+			ranges [uinteger (ithread)]. back = lastElement;
+			firstElement = lastElement + 1;
+		}
+		Melder_assert (firstElement == numberOfElements + 1);
+	}
+
+	void work (integer threadNumber) {
 		/*
-			The following cannot be an `autovector`, because autovectors don't destroy their elements.
-			So it has to be std::vector.
-			Also, the default initialization of a std::thread may not be guaranteed to be all zeroes.
+			A thread that starts late may find that its range has already been stolen from.
+			That's all right: the range handed to the thread function is only its initial range;
+			the real division of the work goes through takeChunk().
 		*/
-		std::vector <std::thread> spawns;
+		MelderThread_Range& range = ranges [uinteger (threadNumber)];
+		integer firstElement, lastElement;
+		{// scope of lock
+			std::lock_guard <std::mutex> lock (range. mutex);
+			firstElement = range. front;
+			lastElement = range. back;
+		}
+		const double startingTime = Melder_clock ();
 		try {
-			spawns. resize (uinteger (numberOfExtraThreads));   // default-construct a number of empty (non-joinable) threads
+			(*threadFunction) (threadNumber, firstElement, lastElement);
 		} catch (...) {
 			/*
-				Turn the system error into a MelderError.
+				Thread functions are not supposed to throw, but std::function may throw for them,
+				and nothing should pass out of a pooled thread.
 			*/
-			Melder_throw (U"Out of memory creating a thread vector. Contact the author if this happens more often.");
+			*p_errorFlag = true;
 		}
-		const integer base = numberOfElements / numberOfThreads;
-		const integer remainder = numberOfElements % numberOfThreads;
-		integer firstElement = 1;
-		try {
-			for (integer ispawn1 = 1; ispawn1 <= numberOfExtraThreads; ispawn1 ++) {   // ispawn1 is base-1
-				const integer lastElement = firstElement + base - 1 + ( ispawn1 <= remainder );
-				spawns [uinteger (ispawn1 - 1)] = std::thread (threadFunction, ispawn1, firstElement, lastElement);
-				firstElement = lastElement + 1;
+		statistics [uinteger (threadNumber)]. busyTime += Melder_clock () - startingTime;
+	}
+
+	bool takeChunk (integer threadNumber, integer *p_firstElement, integer *p_lastElement) {
+		MelderThread_Range& ownRange = ranges [uinteger (threadNumber)];
+		MelderThread_WorkerStatistics& ownStatistics = statistics [uinteger (threadNumber)];
+		for (;;) {
+			{// scope of lock
+				std::lock_guard <std::mutex> lock (ownRange. mutex);
+				if (ownRange. front <= ownRange. back) {
+					*p_firstElement = ownRange. front;
+					*p_lastElement = std::min (ownRange. front + chunkSize - 1, ownRange. back);
+					ownRange. front = *p_lastElement + 1;
+					const integer numberOfElementsInChunk = *p_lastElement - *p_firstElement + 1;
+					numberOfElementsTaken += numberOfElementsInChunk;
+					ownStatistics. numberOfElements += numberOfElementsInChunk;
+					ownStatistics. numberOfChunks += 1;
+					return true;
+				}
+			}
+			if (*p_errorFlag)
+				return false;
+			/*
+				Our own range is empty. Steal the back half of the range of the first thread,
+				after us in circular order, that still has work to do.
+			*/
+			integer stolenFront = 0, stolenBack = -1;
+			for (integer ioffset = 1; ioffset < numberOfThreads; ioffset ++) {
+				MelderThread_Range& victimRange = ranges [uinteger ((threadNumber + ioffset) % numberOfThreads)];
+				std::lock_guard <std::mutex> lock (victimRange. mutex);
+				const integer numberOfElementsLeft = victimRange. back - victimRange. front + 1;
+				if (numberOfElementsLeft <= 0)
+					continue;
+				const integer numberOfElementsToSteal = (numberOfElementsLeft + 1) / 2;
+				stolenBack = victimRange. back;
+				stolenFront = stolenBack - numberOfElementsToSteal + 1;
+				victimRange. back = stolenFront - 1;
+				break;
 			}
+			if (stolenFront > stolenBack)
+				return false;   // all work has been taken
+			ownStatistics. numberOfSteals += 1;
+			std::lock_guard <std::mutex> lock (ownRange. mutex);
+			ownRange. front = stolenFront;
+			ownRange. back = stolenBack;
+		}
+	}
+};
+
+/*
+	The pool's threads are never joined: at exit they are still asleep on their condition variable,
+	and the operating system cleans them up. This is why the pool lives on the heap
+	and its std::threads are detached.
+*/
+struct MelderThread_Pool {
+	std::mutex jobMutex;   // only one job at a time can use the pool
+	std::mutex mutex;   // guards everything below
+	std::condition_variable jobAvailable, jobDone;
+	integer numberOfWorkers = 0;   // the master thread does not count as a worker
+	MelderThread_Job *job = nullptr;
+	integer jobNumber = 0;
+	integer numberOfWorkersWanted = 0, numberOfWorkersBusy = 0;
+	double lastTimeAllIdle = 0.0;
+
+	void workerLoop (integer threadNumber);
+	void ensureNumberOfWorkers (integer numberOfWorkersNeeded);
+	void run (MelderThread_Job *job);
+};
+
+MelderThread_Pool& thePool () {
+	static MelderThread_Pool *pool = new MelderThread_Pool;
+	return *pool;
+}
+
+/*
+	A thread's number in the pool (0 for the master thread) is also its NUMrandom channel,
+	whereas its index in the current job is what it uses to find its own range.
+	The two differ only for a job that is nested in another job.
+*/
+thread_local integer thisThread_threadNumber = 0;
+thread_local MelderThread_Job *thisThread_job = nullptr;
+thread_local integer thisThread_indexInJob = 0;
+
+void MelderThread_Pool :: workerLoop (const integer threadNumber) {
+	thisThread_threadNumber = threadNumber;
+	integer lastJobNumber = 0;
+	for (;;) {
+		MelderThread_Job *myJob;
+		{// scope of lock
+			std::unique_lock <std::mutex> lock (our mutex);
+			our jobAvailable. wait (lock, [&] {
+				return our jobNumber != lastJobNumber && threadNumber <= our numberOfWorkersWanted;
+			});
+			lastJobNumber = our jobNumber;
+			myJob = our job;
+		}
+		thisThread_job = myJob;
+		thisThread_indexInJob = threadNumber;
+		myJob -> work (threadNumber);
+		thisThread_job = nullptr;
+		{// scope of lock
+			std::lock_guard <std::mutex> lock (our mutex);
+			if (-- our numberOfWorkersBusy == 0)
+				our jobDone. notify_one ();
+		}
+	}
+}
+
+void MelderThread_Pool :: ensureNumberOfWorkers (const integer numberOfWorkersNeeded) {
+	while (our numberOfWorkers < numberOfWorkersNeeded) {
+		try {
+			std::thread (& MelderThread_Pool :: workerLoop, this, our numberOfWorkers + 1). detach ();
 		} catch (...) {
-			*p_errorFlag = true;   // try to stop any threads that were already spawned
-			for (size_t ispawn0 = 0; ispawn0 < spawns.size(); ispawn0 ++)   // ispawn0 is base-0
-				if (spawns [ispawn0]. joinable ())   // any extra thread already spawned
-					spawns [ispawn0]. join ();   // wait for the spawned thread to finish, hopefully soon
+			/*
+				Turn the system error into a MelderError.
+			*/
 			Melder_throw (U"Couldn't start a thread. Contact the author.");
 		}
-		Melder_assert (firstElement + base - 1 == numberOfElements);
-		threadFunction (0, firstElement, numberOfElements);
-		for (size_t ispawn0 = 0; ispawn0 < spawns.size(); ispawn0 ++)   // ispawn0 is base-0
-			spawns [ispawn0]. join ();
+		our numberOfWorkers += 1;
+	}
+}
+
+void MelderThread_Pool :: run (MelderThread_Job *newJob) {
+	const integer numberOfExtraThreads = newJob -> numberOfThreads - 1;
+	ensureNumberOfWorkers (numberOfExtraThreads);
+	{// scope of lock
+		std::lock_guard <std::mutex> lock (our mutex);
+		our job = newJob;
+		our numberOfWorkersWanted = numberOfExtraThreads;
+		our numberOfWorkersBusy = numberOfExtraThreads;
+		our jobNumber += 1;
 	}
+	our jobAvailable. notify_all ();
+	thisThread_job = newJob;
+	thisThread_indexInJob = 0;
+	newJob -> work (0);
+	thisThread_job = nullptr;
+	std::unique_lock <std::mutex> lock (our mutex);
+	our jobDone. wait (lock, [&] { return our numberOfWorkersBusy == 0; });
+	our job = nullptr;
+	our numberOfWorkersWanted = 0;
+}
+
+void traceJob (const MelderThread_Job& job, const double wallTime) {
+	Melder_casual (U"MelderThread_run: ", job. numberOfElements, U" elements in ", job. numberOfThreads,
+			U" threads, chunk size ", job. chunkSize, U", ", Melder_fixed (wallTime * 1e3, 3), U" ms");
+	for (integer ithread = 0; ithread < job. numberOfThreads; ithread ++) {
+		const MelderThread_WorkerStatistics& statistics = job. statistics [uinteger (ithread)];
+		Melder_casual (U"   thread ", ithread,
+			U": ", statistics. numberOfElements, U" elements in ", statistics. numberOfChunks, U" chunks (",
+			statistics. numberOfSteals, U" steals); busy ", Melder_fixed (statistics. busyTime * 1e3, 3),
+			U" ms, idle ", Melder_fixed ((wallTime - statistics. busyTime) * 1e3, 3), U" ms"
+		);
+	}
+}
+
+}// end of anonymous namespace
+
+void MelderThread_run (
+	std::atomic <bool> *p_errorFlag,
+	const integer numberOfElements,
+	const integer thresholdNumberOfElementsPerThread,
+	std::function <void (integer threadNumber, integer firstElement, integer lastElement)> const& threadFunction
+) {
+	/* mutable clip */ integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfElements, thresholdNumberOfElementsPerThread);
+	/*
+		A parallel job that is started from within a parallel job
+		(e.g. a Formant analysis inside a parallelized FormantPath candidate)
+		is run on the calling thread only, under the caller's thread number (and therefore NUMrandom channel),
+		so that the total number of threads stays within the budget.
+		The same goes for a job that is started while another thread is using the pool.
+	*/
+	MelderThread_Pool& pool = thePool ();
+	std::unique_lock <std::mutex> poolLock (pool. jobMutex, std::defer_lock);
+	const bool isNested = !! thisThread_job;
+	if (isNested || (numberOfThreads > 1 && ! poolLock. try_lock ()))
+		numberOfThreads = 1;
+	MelderThread_Job job (p_errorFlag, numberOfThreads, numberOfElements, threadFunction);
+	const double startingTime = Melder_clock ();
+	if (numberOfThreads == 1) {
+		MelderThread_Job *const outerJob = thisThread_job;
+		const integer outerIndexInJob = thisThread_indexInJob;
+		thisThread_job = & job;
+		thisThread_indexInJob = 0;
+		try {
+			threadFunction (thisThread_threadNumber, 1, numberOfElements);   // thread number 0 unless nested
+		} catch (...) {
+			thisThread_job = outerJob;
+			thisThread_indexInJob = outerIndexInJob;
+			throw;
+		}
+		thisThread_job = outerJob;
+		thisThread_indexInJob = outerIndexInJob;
+		job. statistics [0]. busyTime = Melder_clock () - startingTime;
+	} else {
+		pool. run (& job);
+	}
+	if (MelderThread_getTraceThreads () && ! isNested)
+		traceJob (job, Melder_clock () - startingTime);
 	if (*p_errorFlag) {
 		theMelder_error_threadId = Melder_thisThread_getUniqueID ();
 		throw MelderError();   // turn the error flag back into a MelderError
@@ -159,11 +402,31 @@ bool MelderThread_getTraceThreads () {
 	return preferences. traceThreads;
 }
 
-static thread_local integer thisThread_firstElement { 0 }, thisThread_lastElement { 0 }, thisThread_currentElement { 0 };
+static thread_local integer thisThread_firstElement { 0 }, thisThread_lastElement { 0 }, thisThread_currentElement { 0 },
+		thisThread_lastElementOfChunk { 0 };
 
 void Melder_thisThread_setRange (integer firstElement, integer lastElement) {
 	thisThread_firstElement = firstElement;
 	thisThread_lastElement = lastElement;
+	thisThread_lastElementOfChunk = 0;
+}
+
+bool Melder_thisThread_takeChunk (integer *p_firstElement, integer *p_lastElement) {
+	if (! thisThread_job) {
+		/*
+			A thread function that is called directly rather than via MelderThread_run
+			does its whole range in one chunk.
+		*/
+		if (thisThread_lastElementOfChunk == thisThread_lastElement)
+			return false;
+		*p_firstElement = thisThread_firstElement;
+		*p_lastElement = thisThread_lastElementOfChunk = thisThread_lastElement;
+		return true;
+	}
+	if (! thisThread_job -> takeChunk (thisThread_indexInJob, p_firstElement, p_lastElement))
+		return false;
+	thisThread_lastElementOfChunk = *p_lastElement;
+	return true;
 }
 
 void Melder_thisThread_setCurrentElement (integer currentElement) {
@@ -171,6 +434,18 @@ void Melder_thisThread_setCurrentElement (integer currentElement) {
 }
 
 double Melder_thisThread_estimateProgress () {
+	if (thisThread_job) {
+		/*
+			With work stealing, the elements of the present thread are no longer contiguous,
+			so we estimate the progress of the whole job instead:
+			all elements taken by any thread, minus what is left of the present thread's chunk.
+		*/
+		const integer numberOfElementsLeftInChunk = thisThread_lastElementOfChunk - thisThread_currentElement;
+		return Melder_clipped (0.0,
+			(thisThread_job -> numberOfElementsTaken - numberOfElementsLeftInChunk - 0.5) / thisThread_job -> numberOfElements,
+			1.0
+		);
+	}
 	return (thisThread_currentElement - thisThread_firstElement + 0.5) / (thisThread_lastElement - thisThread_firstElement + 1.0);
 }
 
@@ -168,6 +168,14 @@ void MelderThread_run (
 	The above procedure can be simplified a bit by using the following four macros.
 	We surround the code by an extra pair of braces in order to allow multiple use within a function.
 	There will also be an extra pair of braces in your written code, so as to suggest scope correctly.
+
+	The macros do more than the hand-written version, though: MelderThread_FOR does not simply
+	cycle from `firstElement` to `lastElement`, but takes small chunks of elements
+	from the thread's own range, and when that range is exhausted, it steals from the ranges of
+	other threads (see MelderThread.cpp). So a thread may see any element,
+	and its elements are not necessarily consecutive. Because the threads come from a pool
+	that lives as long as Praat, the thread number (and therefore the NUMrandom channel)
+	is still unique among the threads of a job.
 */
 
 #define MelderThread_PARALLEL(numberOfElements, thresholdNumberOfElementsPerThread)  \
@@ -181,7 +189,9 @@ void MelderThread_run (
 				Melder_thisThread_setRange (_firstElement_, _lastElement_);
 
 #define MelderThread_FOR(ielement)  \
-				for (integer ielement = _firstElement_; ielement <= _lastElement_; ielement ++) {  \
+				for (integer _firstElementOfChunk_, _lastElementOfChunk_;  \
+					Melder_thisThread_takeChunk (& _firstElementOfChunk_, & _lastElementOfChunk_); )  \
+				for (integer ielement = _firstElementOfChunk_; ielement <= _lastElementOfChunk_; ielement ++) {  \
 					if (_errorFlag_)  \
 						return;  \
 					Melder_thisThread_setCurrentElement (ielement);
@@ -357,11 +367,14 @@ bool MelderThread_getTraceThreads ();
 	NUMrandom_getChannel ()
 
 /*
-	The following three functions are mainly on behalf of progress bars.
+	The following functions are mainly on behalf of the macros and of progress bars.
 */
 
 void Melder_thisThread_setRange (integer firstElement, integer lastElement);
 
+bool Melder_thisThread_takeChunk (integer *p_firstElement, integer *p_lastElement);
+	// false if no work is left
+
 void Melder_thisThread_setCurrentElement (integer currentElement);
 
 double Melder_thisThread_estimateProgress ();
@@ -1,6 +1,6 @@
 /* abcio.cpp
  *
- * Copyright (C) 1992-2011,2015,2017-2020,2022,2024,2025 Paul Boersma
+ * Copyright (C) 1992-2011,2015,2017-2020,2022,2024-2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -1760,6 +1760,112 @@ void binputc128 (dcomplex z, FILE *f) {
 	}
 }
 
+/*
+	Reading and writing many real numbers at once.
+	On little-endian machines, the bytes are read or written with a single `fread` or a few `fwrite`s,
+	and swapped in a loop that the compiler can vectorize.
+	The results have to be identical to those of bingetr32, bingetr64 and binputr64 one number at a time,
+	so that reading maps infinities and NaNs to `undefined`,
+	and writing (on the machines where binputr64 is portable) turns NaNs into +infinity and -0.0 into +0.0.
+*/
+
+static inline bool machineIsLittleEndian () {
+	const uint16 one = 1;
+	return * (const uint8 *) & one == 1;
+}
+
+static inline uint32 swapBytes32 (uint32 x) {
+	return (x >> 24) | ((x >> 8) & 0x0000'FF00) | ((x << 8) & 0x00FF'0000) | (x << 24);   // compiles to a single instruction
+}
+
+static inline uint64 swapBytes64 (uint64 x) {
+	return (uint64) swapBytes32 ((uint32) x) << 32 | swapBytes32 ((uint32) (x >> 32));
+}
+
+static bool bulkIsPossible () {
+	return std::numeric_limits <double>::is_iec559 && sizeof (double) == 8 && sizeof (float) == 4 &&
+		machineIsLittleEndian () && Melder_debug != 18 && Melder_debug != 181;
+}
+
+void bingetr32s (double *x, integer n, FILE *f) {
+	if (! bulkIsPossible ()) {
+		for (integer i = 0; i < n; i ++)
+			x [i] = bingetr32 (f);
+		return;
+	}
+	try {
+		constexpr integer chunkSize = 4096;
+		uint32 chunk [chunkSize];
+		for (integer offset = 0; offset < n; offset += chunkSize) {
+			const integer numberOfValues = std::min (chunkSize, n - offset);
+			if (fread (chunk, sizeof (uint32), (size_t) numberOfValues, f) != (size_t) numberOfValues)
+				readError (f, U"32-bit floating-point numbers.");
+			for (integer i = 0; i < numberOfValues; i ++) {
+				const uint32 bits = swapBytes32 (chunk [i]);
+				float value;
+				memcpy (& value, & bits, 4);
+				x [offset + i] = ( isfinite (value) ? (double) value : undefined );
+			}
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not read from 4 bytes each in binary file.");
+	}
+}
+
+void bingetr64s (double *x, integer n, FILE *f) {
+	if (! bulkIsPossible ()) {
+		for (integer i = 0; i < n; i ++)
+			x [i] = bingetr64 (f);
+		return;
+	}
+	try {
+		if (n > 0 && fread (x, sizeof (double), (size_t) n, f) != (size_t) n)
+			readError (f, U"64-bit floating-point numbers.");
+		for (integer i = 0; i < n; i ++) {
+			uint64 bits;
+			memcpy (& bits, & x [i], 8);
+			bits = swapBytes64 (bits);
+			memcpy (& x [i], & bits, 8);
+		}
+		for (integer i = 0; i < n; i ++)
+			if (! isfinite (x [i]))
+				x [i] = undefined;
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not read from 8 bytes each in binary file.");
+	}
+}
+
+void binputr64s (const double *x, integer n, FILE *f) {
+	if (! bulkIsPossible ()) {
+		for (integer i = 0; i < n; i ++)
+			binputr64 (x [i], f);
+		return;
+	}
+	try {
+		constexpr integer chunkSize = 4096;
+		uint64 chunk [chunkSize];
+		for (integer offset = 0; offset < n; offset += chunkSize) {
+			const integer numberOfValues = std::min (chunkSize, n - offset);
+			memcpy (chunk, x + offset, (size_t) numberOfValues * sizeof (double));
+			if (! binario_doubleIEEE8lsb) {
+				for (integer i = 0; i < numberOfValues; i ++) {
+					const double value = x [offset + i];
+					if (value == 0.0)
+						chunk [i] = 0;
+					else if (! isfinite (value))
+						chunk [i] = ( value < 0.0 ? 0xFFF0'0000'0000'0000 : 0x7FF0'0000'0000'0000 );
+				}
+			}
+			for (integer i = 0; i < numberOfValues; i ++)
+				chunk [i] = swapBytes64 (chunk [i]);
+			if (fwrite (chunk, sizeof (uint64), (size_t) numberOfValues, f) != (size_t) numberOfValues)
+				writeError (U"64-bit floating-point numbers.");
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not written to 8 bytes each in binary file.");
+	}
+}
+
 autostring8 bingets8 (FILE *f) {
 	try {
 		uint32 length = bingetu8 (f);
@@ -158,6 +158,13 @@ double bingetr80 (FILE *f);   void binputr80 (double x, FILE *f);
 	and is the native format of a `double` on 68k Macintosh.
 */
 
+void bingetr32s (double *x, integer n, FILE *f);
+void bingetr64s (double *x, integer n, FILE *f);   void binputr64s (const double *x, integer n, FILE *f);
+/*
+	Read or write the `n` real numbers x [0] through x [n - 1] as consecutive numbers in the stream `f`,
+	with the same result as calling bingetr32, bingetr64 or binputr64 `n` times, but much faster.
+*/
+
 dcomplex bingetc64 (FILE *f);
 dcomplex bingetc128 (FILE *f);
 void binputc64 (dcomplex z, FILE *f);
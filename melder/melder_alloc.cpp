@@ -1,6 +1,6 @@
 /* melder_alloc.cpp
  *
- * Copyright (C) 1992-2007,2009,2011,2012,2014-2020,2022-2025 Paul Boersma
+ * Copyright (C) 1992-2007,2009,2011,2012,2014-2020,2022-2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -18,6 +18,12 @@
 
 #include "melder.h"
 #include <assert.h>
+#include <map>
+#include <mutex>
+#if ! defined (_WIN32)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
 
 static std::atomic <int64> totalNumberOfAllocations = 0, totalNumberOfDeallocations = 0, totalAllocationSize = 0,
 	totalNumberOfMovingReallocs = 0, totalNumberOfReallocsInSitu = 0;
@@ -294,6 +300,84 @@ int64 Melder_movingReallocationsCount () {
 	return totalNumberOfMovingReallocs;
 }
 
+#pragma mark - Memory-mapped files
+
+namespace MelderArray { // reopen
+	struct MappedFile {
+		integer numberOfBytes;
+		integer numberOfReferences;
+	};
+	static std::map <byte *, MappedFile> theMappedFiles;   // sorted by start address
+	static std::atomic <integer> theNumberOfMappedFiles = 0;   // for a quick check in _free_generic
+	static std::mutex theMappedFilesMutex;   // tensors can be freed from any thread
+
+	static auto findMappedFile (byte *cells) {
+		/*
+			Precondition: theMappedFilesMutex is locked.
+		*/
+		auto it = theMappedFiles. upper_bound (cells);   // the first mapping that starts after `cells`
+		if (it == theMappedFiles. begin ())
+			return theMappedFiles. end ();
+		-- it;   // the last mapping that starts at or before `cells`
+		if (cells >= it -> first + it -> second. numberOfBytes)
+			return theMappedFiles. end ();
+		return it;
+	}
+
+	static void releaseMappedFile (decltype (theMappedFiles. begin ()) it) noexcept {
+		/*
+			Precondition: theMappedFilesMutex is locked.
+		*/
+		if (-- it -> second. numberOfReferences > 0)
+			return;
+		#if ! defined (_WIN32)
+			munmap (it -> first, (size_t) it -> second. numberOfBytes);
+		#endif
+		theMappedFiles. erase (it);
+		theNumberOfMappedFiles -= 1;
+	}
+}
+
+byte * MelderArray:: _mapFile (FILE *f, integer *out_numberOfBytes) {
+	#if defined (_WIN32)
+		(void) f;
+		*out_numberOfBytes = 0;
+		return nullptr;
+	#else
+		fflush (f);
+		struct stat status;
+		if (fstat (fileno (f), & status) != 0 || status. st_size <= 0)
+			return nullptr;
+		const integer numberOfBytes = status. st_size;
+		void *mapping = mmap (nullptr, (size_t) numberOfBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno (f), 0);
+		if (mapping == MAP_FAILED)
+			return nullptr;
+		std::lock_guard <std::mutex> lock (theMappedFilesMutex);
+		theMappedFiles [(byte *) mapping] = { numberOfBytes, 1 };   // the reference of the reader
+		theNumberOfMappedFiles += 1;
+		*out_numberOfBytes = numberOfBytes;
+		return (byte *) mapping;
+	#endif
+}
+
+void MelderArray:: _useMappedCells (byte *mapping) {
+	std::lock_guard <std::mutex> lock (theMappedFilesMutex);
+	auto it = theMappedFiles. find (mapping);
+	Melder_assert (it != theMappedFiles. end ());
+	it -> second. numberOfReferences += 1;
+}
+
+void MelderArray:: _unmapFile (byte *mapping) noexcept {
+	std::lock_guard <std::mutex> lock (theMappedFilesMutex);
+	auto it = theMappedFiles. find (mapping);
+	if (it != theMappedFiles. end ())
+		releaseMappedFile (it);
+}
+
+integer MelderArray:: _numberOfMappedFiles () {
+	return theNumberOfMappedFiles;
+}
+
 #pragma mark - Generic memory functions for vectors and matrices
 
 namespace MelderArray { // reopen
@@ -324,6 +408,14 @@ byte * MelderArray:: _alloc_generic (integer cellSize, integer numberOfCells, kI
 void MelderArray:: _free_generic (byte *cells, integer numberOfCells) noexcept {
 	if (! cells)
 		return;   // not an error
+	if (theNumberOfMappedFiles > 0) {
+		std::lock_guard <std::mutex> lock (theMappedFilesMutex);
+		auto it = findMappedFile (cells);
+		if (it != theMappedFiles. end ()) {
+			releaseMappedFile (it);
+			return;   // not counted as a deallocation, because the cells were not counted as an allocation
+		}
+	}
 	Melder_free (cells);
 	MelderArray::deallocationCount += 1;
 	MelderArray::cellDeallocationCount += numberOfCells;
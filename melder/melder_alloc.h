@@ -87,6 +87,21 @@ namespace MelderArray {
 		_free_generic (reinterpret_cast <byte *> (cells), numberOfCells);
 	}
 
+	/*
+		The cells of a tensor can also lie in a file that has been mapped into memory,
+		so that a large object can be read from disk without copying its payload (see Data_readFromBinaryFile).
+		The mapping is private: writing into the cells changes only the memory of this process,
+		and only the pages that are written into are copied.
+		Every tensor that uses cells in a mapping holds a reference to it,
+		and so does the reader of the file, until it calls _unmapFile;
+		the file is unmapped when the last reference goes away.
+		_free_generic recognizes cells in a mapping, and releases the reference instead of freeing them.
+	*/
+	byte * _mapFile (FILE *f, integer *out_numberOfBytes);   // null if this system cannot map files
+	void _useMappedCells (byte *mapping);
+	void _unmapFile (byte *mapping) noexcept;
+	integer _numberOfMappedFiles ();
+
 }
 
 int64 MelderArray_allocationCount ();
@@ -1688,6 +1688,83 @@ static void warning_fileTooSmall (MelderFile file, integer numberOfChannels, con
 			numberOfChannels, U"-channel ", type, U").\nMissing samples were set to zero.");
 }
 
+/*
+	Read the interleaved samples in chunks of many values, each chunk with a single `fread`,
+	and convert and deinterleave them with `convert`, which receives the bytes of one value.
+	Returns false if the file turns out to be too small;
+	the values that could be read have been stored, and the rest of the buffer is left alone.
+*/
+template <integer numberOfBytesPerValue, typename Converter>
+static bool readInterleavedValues (FILE *f, MAT const& buffer, Converter convert) {
+	constexpr integer chunkSize = 8192;
+	uint8 chunk [chunkSize * numberOfBytesPerValue];
+	const integer numberOfChannels = buffer.nrow;
+	const integer numberOfValues = buffer.nrow * buffer.ncol;
+	integer ichan = 1, isamp = 1;
+	for (integer offset = 0; offset < numberOfValues; offset += chunkSize) {
+		const integer numberOfValuesToRead = std::min (chunkSize, numberOfValues - offset);
+		const integer numberOfValuesRead = (integer) fread (chunk, numberOfBytesPerValue, (size_t) numberOfValuesToRead, f);
+		const uint8 *bytes = chunk;
+		if (numberOfChannels == 1) {
+			double *samples = & buffer [1] [isamp];
+			for (integer ivalue = 0; ivalue < numberOfValuesRead; ivalue ++, bytes += numberOfBytesPerValue)
+				samples [ivalue] = convert (bytes);
+			isamp += numberOfValuesRead;
+		} else {
+			for (integer ivalue = 0; ivalue < numberOfValuesRead; ivalue ++, bytes += numberOfBytesPerValue) {
+				buffer [ichan] [isamp] = convert (bytes);
+				if (++ ichan > numberOfChannels) {
+					ichan = 1;
+					isamp ++;
+				}
+			}
+		}
+		if (numberOfValuesRead < numberOfValuesToRead)
+			return false;
+	}
+	return true;
+}
+
+static bool readInterleavedBytesViaTable (FILE *f, MAT const& buffer, const double table [256]) {
+	return readInterleavedValues <1> (f, buffer, [table] (const uint8 *bytes) { return table [*bytes]; });
+}
+
+/*
+	IEEE floating-point values in the byte order of the machine are kept as they are,
+	as bingetr32LE and bingetr64LE do on little-endian machines;
+	values in the other byte order are converted, with infinities and NaNs becoming `undefined`,
+	as bingetr32 and bingetr64 do on little-endian machines.
+*/
+static bool readInterleavedFloat32 (FILE *f, MAT const& buffer, bool fileIsLittleEndian) {
+	static_assert (std::numeric_limits <float>::is_iec559 && sizeof (float) == 4);
+	const bool fileHasNativeByteOrder = ( fileIsLittleEndian == MelderBinary2_machineIsLittleEndian () );
+	return readInterleavedValues <4> (f, buffer, [fileHasNativeByteOrder] (const uint8 *bytes) {
+		float value;
+		if (fileHasNativeByteOrder) {
+			memcpy (& value, bytes, 4);
+			return (double) value;
+		}
+		const uint8 swappedBytes [4] = { bytes [3], bytes [2], bytes [1], bytes [0] };
+		memcpy (& value, swappedBytes, 4);
+		return isfinite (value) ? (double) value : undefined;
+	});
+}
+
+static bool readInterleavedFloat64 (FILE *f, MAT const& buffer, bool fileIsLittleEndian) {
+	static_assert (std::numeric_limits <double>::is_iec559 && sizeof (double) == 8);
+	const bool fileHasNativeByteOrder = ( fileIsLittleEndian == MelderBinary2_machineIsLittleEndian () );
+	return readInterleavedValues <8> (f, buffer, [fileHasNativeByteOrder] (const uint8 *bytes) {
+		double value;
+		if (fileHasNativeByteOrder) {
+			memcpy (& value, bytes, 8);
+			return value;
+		}
+		const uint8 swappedBytes [8] = { bytes [7], bytes [6], bytes [5], bytes [4], bytes [3], bytes [2], bytes [1], bytes [0] };
+		memcpy (& value, swappedBytes, 8);
+		return isfinite (value) ? value : undefined;
+	});
+}
+
 void Melder_readAudioToFloat (MelderFile file, int encoding, MAT buffer) {
 	FILE *f = file -> filePointer;   // this function must have a MelderFile argument, because it can warn (which needs a filename)
 	try {
@@ -1695,28 +1772,19 @@ void Melder_readAudioToFloat (MelderFile file, int encoding, MAT buffer) {
 		integer numberOfSamples = buffer.ncol;
 		switch (encoding) {
 			case Melder_LINEAR_8_SIGNED: {
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++)
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							int8 value;
-							if (fread (& value, 1, 1, f) < 1) throw MelderError ();
-							buffer [ichan] [isamp] = value * (1.0 / 128);
-						}
-				} catch (MelderError) {
-					Melder_clearError ();
+				double table [256];
+				for (integer byte = 0; byte < 256; byte ++)
+					table [byte] = (int8) (uint8) byte * (1.0 / 128);
+				if (! readInterleavedBytesViaTable (f, buffer, table))
 					warning_fileTooSmall (file, numberOfChannels, U"8-bit signed");
-				}
 			} break;
-			case Melder_LINEAR_8_UNSIGNED:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++)
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
-							buffer [ichan] [isamp] = bingetu8 (f) * (1.0 / 128) - 1.0;
-				} catch (MelderError) {
-					Melder_clearError ();
+			case Melder_LINEAR_8_UNSIGNED: {
+				double table [256];
+				for (integer byte = 0; byte < 256; byte ++)
+					table [byte] = byte * (1.0 / 128) - 1.0;
+				if (! readInterleavedBytesViaTable (f, buffer, table))
 					warning_fileTooSmall (file, numberOfChannels, U"8-bit unsigned");
-				}
-				break;
+			} break;
 			case Melder_LINEAR_16_BIG_ENDIAN:
 			case Melder_LINEAR_16_LITTLE_ENDIAN:
 			case Melder_LINEAR_24_BIG_ENDIAN:
@@ -1978,65 +2046,29 @@ void Melder_readAudioToFloat (MelderFile file, int encoding, MAT buffer) {
 							U"Missing samples were set to zero.");
 			} break;
 			case Melder_IEEE_FLOAT_32_BIG_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++)
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
-							buffer [ichan] [isamp] = bingetr32 (f);
-				} catch (MelderError) {
-					Melder_clearError ();
-					warning_fileTooSmall (file, numberOfChannels, U"32-bit floating point");
-				}
-				break;
 			case Melder_IEEE_FLOAT_32_LITTLE_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++)
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
-							buffer [ichan] [isamp] = bingetr32LE (f);
-				} catch (MelderError) {
-					Melder_clearError ();
+				if (! readInterleavedFloat32 (f, buffer, encoding == Melder_IEEE_FLOAT_32_LITTLE_ENDIAN))
 					warning_fileTooSmall (file, numberOfChannels, U"32-bit floating point");
-				}
 				break;
 			case Melder_IEEE_FLOAT_64_BIG_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++)
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
-							buffer [ichan] [isamp] = bingetr64 (f);
-				} catch (MelderError) {
-					Melder_clearError ();
-					warning_fileTooSmall (file, numberOfChannels, U"64-bit floating point");
-				}
-				break;
 			case Melder_IEEE_FLOAT_64_LITTLE_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++)
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
-							buffer [ichan] [isamp] = bingetr64LE (f);
-				} catch (MelderError) {
-					Melder_clearError ();
+				if (! readInterleavedFloat64 (f, buffer, encoding == Melder_IEEE_FLOAT_64_LITTLE_ENDIAN))
 					warning_fileTooSmall (file, numberOfChannels, U"64-bit floating point");
-				}
 				break;
-			case Melder_MULAW:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++)
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
-							buffer [ichan] [isamp] = ulaw2linear [bingetu8 (f)] * (1.0 / 32768);
-				} catch (MelderError) {
-					Melder_clearError ();
+			case Melder_MULAW: {
+				double table [256];
+				for (integer byte = 0; byte < 256; byte ++)
+					table [byte] = ulaw2linear [byte] * (1.0 / 32768);
+				if (! readInterleavedBytesViaTable (f, buffer, table))
 					warning_fileTooSmall (file, numberOfChannels, U"8-bit μ-law");
-				}
-				break;
-			case Melder_ALAW:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++)
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
-							buffer [ichan] [isamp] = alaw2linear [bingetu8 (f)] * (1.0 / 32768);
-				} catch (MelderError) {
-					Melder_clearError ();
+			} break;
+			case Melder_ALAW: {
+				double table [256];
+				for (integer byte = 0; byte < 256; byte ++)
+					table [byte] = alaw2linear [byte] * (1.0 / 32768);
+				if (! readInterleavedBytesViaTable (f, buffer, table))
 					warning_fileTooSmall (file, numberOfChannels, U"8-bit A-law");
-				}
-				break;
+			} break;
 			case Melder_FLAC_COMPRESSION_16:
 			case Melder_FLAC_COMPRESSION_24:
 			case Melder_FLAC_COMPRESSION_32:
@@ -88,6 +88,11 @@ the behaviour of Praat will temporarily change in the following ways:
 56: trace text styles
 57: no parabolic interpolation in Sound_Pitch_to_PointProcess_cc (March 2024)
 58: list font replacements at start-up (December 2025)
+59: FFT: use FFTPACK for all sizes, instead of the mixed-radix transform (October 2026)
+60: FFT: mixed-radix transform with 16-byte vectors only, i.e. no AVX2 (October 2026)
+61: FFT: Bluestein's algorithm for all sizes from 8 on that the mixed-radix transform cannot handle directly (October 2026)
+62: Sound_to_Intensity: always compute each frame directly (October 2026)
+63: Sound_to_Intensity: always compute via Fourier convolution (October 2026)
 181: read and write native-endian real64
 900: use DG Meta Serif Science instead of Palatino
 1264: Mac: Sound_record_fixedTime uses microphone "FW Solo (1264)"
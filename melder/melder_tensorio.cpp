@@ -20,6 +20,152 @@
 
 /*** Typed I/O functions for vectors and matrices. ***/
 
+/*
+	State of the binary file of the second kind that is being read or written, if any.
+*/
+static MelderBinary2State theBinary2;
+
+bool MelderBinary2_machineIsLittleEndian () {
+	const uint16 one = 1;
+	return * (const uint8 *) & one == 1;
+}
+
+autoMelderBinary2Tensors :: autoMelderBinary2Tensors () : _previousState (theBinary2) {
+	theBinary2. isActive = true;
+	theBinary2. fileHasNativeByteOrder = true;
+	theBinary2. fileIsLittleEndian = MelderBinary2_machineIsLittleEndian ();
+	theBinary2. mapping = nullptr;
+	theBinary2. mappingSize = 0;
+}
+
+autoMelderBinary2Tensors :: autoMelderBinary2Tensors (FILE *f, bool fileIsLittleEndian) : _previousState (theBinary2) {
+	theBinary2. isActive = true;
+	theBinary2. fileHasNativeByteOrder = ( fileIsLittleEndian == MelderBinary2_machineIsLittleEndian () );
+	theBinary2. fileIsLittleEndian = fileIsLittleEndian;
+	theBinary2. mapping = nullptr;
+	theBinary2. mappingSize = 0;
+	if (theBinary2. fileHasNativeByteOrder)
+		theBinary2. mapping = _ownMapping = MelderArray:: _mapFile (f, & theBinary2. mappingSize);   // null if not possible
+}
+
+autoMelderBinary2Tensors :: ~autoMelderBinary2Tensors () {
+	if (_ownMapping)
+		MelderArray:: _unmapFile (_ownMapping);
+	theBinary2 = _previousState;
+}
+
+static int64 alignedPosition (int64 position) {
+	constexpr int64 alignment = 64;   // a cache line, and the width of the widest SIMD registers
+	return (position + alignment - 1) / alignment * alignment;
+}
+
+static double *readCells_binary2 (integer n, FILE *f) {
+	const int64 start = alignedPosition (ftello (f));
+	const int64 numberOfBytes = n * (int64) sizeof (double);
+	if (n == 0) {
+		fseeko (f, start, SEEK_SET);
+		return nullptr;   // as from MelderArray::_alloc
+	}
+	if (theBinary2. mapping) {
+		Melder_assert (theBinary2. fileHasNativeByteOrder);
+		if (start + numberOfBytes > theBinary2. mappingSize)
+			Melder_throw (U"Early end of file.");
+		if (fseeko (f, start + numberOfBytes, SEEK_SET) != 0)
+			Melder_throw (U"Cannot skip ", numberOfBytes, U" bytes in file.");
+		MelderArray:: _useMappedCells (theBinary2. mapping);
+		return reinterpret_cast <double *> (theBinary2. mapping + start);
+	}
+	if (fseeko (f, start, SEEK_SET) != 0)
+		Melder_throw (U"Early end of file.");
+	autovector <double> cells = newvectorraw <double> (n);
+	if (theBinary2. fileHasNativeByteOrder) {
+		if (fread (cells.cells, sizeof (double), (size_t) n, f) != (size_t) n)
+			Melder_throw (U"Early end of file.");
+	} else if (theBinary2. fileIsLittleEndian) {
+		for (integer i = 1; i <= n; i ++)
+			cells [i] = bingetr64LE (f);
+	} else {
+		bingetr64s (cells.cells, n, f);
+	}
+	return cells.releaseToAmbiguousOwner().cells;
+}
+
+static void writeCells_binary2 (const double *x, integer n, FILE *f) {
+	const int64 position = ftello (f);
+	for (int64 i = position; i < alignedPosition (position); i ++)
+		binputu8 (0, f);
+	if (n > 0 && fwrite (x, sizeof (double), (size_t) n, f) != (size_t) n)
+		Melder_throw (U"Error in file while trying to write ", n, U" real numbers.");
+}
+
+/*
+	Binary reading and writing of consecutive elements.
+	Real numbers (which are most of what is in binary files) are read or written in bulk;
+	the other types one element at a time.
+	The cells that are read are returned as a new payload for a tensor.
+*/
+#define ELEMENTWISE_READ(T,storage)  \
+	static T *readCells_##storage (integer n, FILE *f) { \
+		autovector <T> cells = newvectorraw <T> (n); \
+		for (integer i = 1; i <= n; i ++) \
+			cells [i] = binget##storage (f); \
+		return cells.releaseToAmbiguousOwner().cells; \
+	}
+#define ELEMENTWISE_WRITE(T,storage)  \
+	static void writeCells_##storage (const T *x, integer n, FILE *f) { \
+		for (integer i = 0; i < n; i ++) \
+			binput##storage (x [i], f); \
+	}
+ELEMENTWISE_READ (signed char, i8)
+ELEMENTWISE_WRITE (signed char, i8)
+ELEMENTWISE_READ (int, i16)
+ELEMENTWISE_WRITE (int, i16)
+ELEMENTWISE_READ (long, i32)
+ELEMENTWISE_WRITE (long, i32)
+ELEMENTWISE_READ (integer, integer32BE)
+ELEMENTWISE_WRITE (integer, integer32BE)
+ELEMENTWISE_READ (integer, integer16BE)
+ELEMENTWISE_WRITE (integer, integer16BE)
+ELEMENTWISE_READ (unsigned char, u8)
+ELEMENTWISE_WRITE (unsigned char, u8)
+ELEMENTWISE_READ (unsigned int, u16)
+ELEMENTWISE_WRITE (unsigned int, u16)
+ELEMENTWISE_READ (unsigned long, u32)
+ELEMENTWISE_WRITE (unsigned long, u32)
+ELEMENTWISE_WRITE (double, r32)   // binputr32 truncates, which a bulk conversion to `float` would not do
+ELEMENTWISE_READ (dcomplex, c64)
+ELEMENTWISE_WRITE (dcomplex, c64)
+ELEMENTWISE_READ (bool, eb)
+ELEMENTWISE_WRITE (bool, eb)
+#undef ELEMENTWISE_READ
+#undef ELEMENTWISE_WRITE
+static double *readCells_r32 (integer n, FILE *f) {
+	autovector <double> cells = newvectorraw <double> (n);
+	bingetr32s (cells.cells, n, f);
+	return cells.releaseToAmbiguousOwner().cells;
+}
+static double *readCells_r64 (integer n, FILE *f) {
+	if (theBinary2. isActive)
+		return readCells_binary2 (n, f);
+	autovector <double> cells = newvectorraw <double> (n);
+	bingetr64s (cells.cells, n, f);
+	return cells.releaseToAmbiguousOwner().cells;
+}
+static void writeCells_r64 (const double *x, integer n, FILE *f) {
+	if (theBinary2. isActive)
+		writeCells_binary2 (x, n, f);
+	else
+		binputr64s (x, n, f);
+}
+static dcomplex *readCells_c128 (integer n, FILE *f) {
+	autovector <dcomplex> cells = newvectorraw <dcomplex> (n);
+	bingetr64s (reinterpret_cast <double *> (cells.cells), 2 * n, f);   // the real and imaginary parts are consecutive, both in memory and in the file
+	return cells.releaseToAmbiguousOwner().cells;
+}
+static void writeCells_c128 (const dcomplex *x, integer n, FILE *f) {
+	binputr64s (reinterpret_cast <const double *> (x), 2 * n, f);
+}
+
 #define FUNCTION(T,storage)  \
 	void vector_writeText_##storage (const constvector<T>& vec, MelderFile file, conststring32 name) { \
 		texputintro (file, name, U" []: ", vec.size >= 1 ? nullptr : U"(empty)", 0,0,0); \
@@ -29,8 +175,7 @@
 		if (feof (file -> filePointer) || ferror (file -> filePointer)) Melder_throw (U"Write error."); \
 	} \
 	void vector_writeBinary_##storage (const constvector<T>& vec, FILE *f) { \
-		for (integer i = 1; i <= vec.size; i ++) \
-			binput##storage (vec [i], f); \
+		writeCells_##storage (vec.cells, vec.size, f); \
 		if (feof (f) || ferror (f)) Melder_throw (U"Write error."); \
 	} \
 	autovector<T> vector_readText_##storage (integer size, MelderReadText text, const char *name) { \
@@ -45,10 +190,8 @@
 		return result; \
 	} \
 	autovector<T> vector_readBinary_##storage (integer size, FILE *f) { \
-		autovector<T> result = newvectorzero<T> (size); \
-		for (integer i = 1; i <= size; i ++) { \
-			result [i] = binget##storage (f); \
-		} \
+		autovector<T> result; \
+		result. adoptFromAmbiguousOwner (vector<T> (readCells_##storage (size, f), size)); \
 		return result; \
 	} \
 	void matrix_writeText_##storage (const constmatrix<T>& mat, MelderFile file, conststring32 name) { \
@@ -64,10 +207,7 @@
 		if (feof (file -> filePointer) || ferror (file -> filePointer)) Melder_throw (U"Write error."); \
 	} \
 	void matrix_writeBinary_##storage (const constmatrix<T>& mat, FILE *f) { \
-		for (integer irow = 1; irow <= mat.nrow; irow ++) { \
-			for (integer icol = 1; icol <= mat.ncol; icol ++) \
-				binput##storage (mat [irow] [icol], f); \
-		} \
+		writeCells_##storage (mat.cells, mat.nrow * mat.ncol, f);   /* the rows are consecutive */ \
 		if (feof (f) || ferror (f)) Melder_throw (U"Write error."); \
 	} \
 	automatrix<T> matrix_readText_##storage (integer nrow, integer ncol, MelderReadText text, const char *name) { \
@@ -82,9 +222,8 @@
 		return result; \
 	} \
 	automatrix<T> matrix_readBinary_##storage (integer nrow, integer ncol, FILE *f) { \
-		automatrix<T> result = newmatrixzero<T> (nrow, ncol); \
-		for (integer irow = 1; irow <= nrow; irow ++) for (integer icol = 1; icol <= ncol; icol ++) \
-			result [irow] [icol] = binget##storage (f); \
+		automatrix<T> result; \
+		result. adoptFromAmbiguousOwner (matrix<T> (readCells_##storage (nrow * ncol, f), nrow, ncol)); \
 		return result; \
 	} \
 	void tensor3_writeText_##storage (const consttensor3<T>& ten3, MelderFile file, conststring32 name) { \
@@ -2,7 +2,7 @@
 #define _melder_tensorio_h_
 /* melder_tensorio.h
  *
- * Copyright (C) 1992-2020 Paul Boersma
+ * Copyright (C) 1992-2020,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -77,5 +77,31 @@ automatrix <double> matrix_readBinary_r64 (integer nrow, integer ncol, FILE *f);
 	Throw an error message if anything went wrong.
 */
 
+/*
+	Binary files of the second kind ("ooBinary2File", see Data_writeToMappableBinaryFile)
+	store real-valued vectors and matrices (storage r64) in the byte order of the machine that wrote them,
+	starting at a multiple of 64 bytes from the start of the file,
+	so that a reader on a machine with the same byte order can use them in place, from a memory-mapped file.
+	All other data are stored as in binary files of the first kind.
+	While such a file is being written or read, an autoMelderBinary2Tensors should be alive.
+*/
+struct MelderBinary2State {
+	bool isActive;
+	bool fileHasNativeByteOrder, fileIsLittleEndian;
+	byte *mapping;   // the start of the memory-mapped file (see MelderArray::_mapFile), or null
+	integer mappingSize;
+};
+struct autoMelderBinary2Tensors {
+	autoMelderBinary2Tensors ();   // for writing, in the native byte order
+	autoMelderBinary2Tensors (FILE *f, bool fileIsLittleEndian);   // for reading; maps the file into memory if it has the native byte order
+	~autoMelderBinary2Tensors ();   // restores the previous state, and lets go of the mapping (tensors that live in it keep it alive)
+	autoMelderBinary2Tensors (autoMelderBinary2Tensors const& other) = delete;
+	autoMelderBinary2Tensors& operator= (autoMelderBinary2Tensors const& other) = delete;
+private:
+	MelderBinary2State _previousState;
+	byte *_ownMapping = nullptr;
+};
+bool MelderBinary2_machineIsLittleEndian ();
+
 /* End of file melder_tensorio.h */
 #endif
@@ -147,6 +147,29 @@ void Data_writeToBinaryFile (Daata me, MelderFile file) {
 	}
 }
 
+void Data_writeToMappableBinaryFile (Daata me, MelderFile file) {
+	try {
+		if (! Data_canWriteBinary (me))
+			Melder_throw (U"Objects of class ", my classInfo -> className, U" cannot be written to a generic binary file.");
+		autoMelderFile mfile = MelderFile_create (file);
+		if (fprintf (file -> filePointer, "ooBinary2File") < 0)
+			Melder_throw (U"Cannot write first bytes of file.");
+		binputu8 (MelderBinary2_machineIsLittleEndian (), file -> filePointer);   // the byte order of the real-valued tensors
+		binputw8 (
+			my classInfo -> version > 0 ?
+				Melder_cat (my classInfo -> className, U" ", my classInfo -> version) :
+				my classInfo -> className,
+			file -> filePointer);
+		{// scope
+			autoMelderBinary2Tensors binary2;
+			Data_writeBinary (me, file -> filePointer);
+		}
+		mfile.close ();
+	} catch (MelderError) {
+		Melder_throw (me, U": not written to mappable binary file ", file, U".");
+	}
+}
+
 bool Data_canReadText (Daata me) {
 	return my v_writable ();
 }
@@ -219,14 +242,30 @@ autoDaata Data_readFromBinaryFile (MelderFile file) {
 		char line [200];
 		size_t n = fread (line, 1, 199, f); line [n] = '\0';
 		/*
-			Allow for a future version of binary files, which can handle 64-bit integers
-			and are perhaps written in little-endian format.
-			This check was written on 2017-09-10, and should stay for at least a year;
-			ooBinary2 files can therefore be implemented from some moment after 2018-09-10.
+			Binary files of the second kind (since 2026) have their real-valued vectors and matrices
+			in the byte order of the machine that wrote them, aligned so that they can be used in place
+			from a memory-mapped file (see melder_tensorio.h).
+			Their first byte after "ooBinary2File" tells the byte order;
+			a future version of binary files can use other values there.
 			Please compare with `Data_readFromTextFile` above.
 		*/
-		if (strstr (line, "ooBinary2File"))
-			Melder_throw (U"This Praat version cannot read this Praat file. Please download a newer version of Praat.");
+		if (strstr (line, "ooBinary2File") == line) {
+			fseeko (f, strlen ("ooBinary2File"), SEEK_SET);
+			const uint32 byteOrder = bingetu8 (f);
+			if (byteOrder > 1)
+				Melder_throw (U"This Praat version cannot read this Praat file. Please download a newer version of Praat.");
+			autostring8 klas = bingets8 (f);
+			int formatVersion;
+			autoDaata me = Thing_newFromClassName (Melder_peek8to32_u (klas.get()), & formatVersion).static_cast_move <structDaata>();
+			MelderFile_getParentFolder (file, & Data_directoryBeingRead);
+			{// scope
+				autoMelderBinary2Tensors binary2 (f, byteOrder == 1);
+				Data_readBinary (me.get(), f, formatVersion);
+			}
+			file -> format = structMelderFile :: Format :: binary;
+			f.close (file);
+			return me;
+		}
 		char *end = strstr (line, "ooBinaryFile");
 		autoDaata me;
 		int formatVersion;
@@ -187,6 +187,19 @@ void Data_writeToBinaryFile (Daata me, MelderFile file);
 		The format of the file after this is the same as in Data_writeBinary.
 */
 
+void Data_writeToMappableBinaryFile (Daata me, MelderFile file);
+/*
+	Message:
+		"try to write yourself as binary data to a file that can be read back quickly, by memory mapping".
+	Description:
+		The file starts with "ooBinary2File", followed by the byte order of the machine and your class name.
+		The format of the file after this is the same as in Data_writeBinary,
+		except that real-valued vectors and matrices are written in the byte order of the machine,
+		each starting at a multiple of 64 bytes from the start of the file.
+		Data_readFromBinaryFile can read this format; on a machine with the same byte order,
+		such vectors and matrices point directly into the (privately) memory-mapped file.
+*/
+
 bool Data_canReadText (Daata me);
 /*
 	Message:
@@ -33,16 +33,21 @@
 #include "Notebook.h"
 #include "DemoEditor.h"
 
-static Interpreter theInterpreter;
-static autoInterpreterStack theLocalInterpreterStack;
-static Daata theSource;
-static conststring32 theExpression;
-static int theLevel = 1;
+/*
+	All the state of the compiler and of the run-time engine is thread-local,
+	so that formulas can be compiled and run on several threads at the same time.
+	A compiled formula that is to be run more than once, or on several threads,
+	should be kept in a FormulaProgram (see Formula.h).
+*/
+static thread_local Interpreter theInterpreter;
+static thread_local autoInterpreterStack theLocalInterpreterStack;
+static thread_local Daata theSource;
+static thread_local conststring32 theExpression;
+static thread_local int theLevel = 1;
 #define MAXIMUM_NUMBER_OF_LEVELS  20
-static int theExpressionType [1 + MAXIMUM_NUMBER_OF_LEVELS];
-static bool theOptimize;
+static thread_local bool theOptimize;
 
-typedef struct structFormulaInstruction {
+struct structFormulaInstruction {
 	integer symbol;
 	integer position;
 	union {
@@ -52,10 +57,10 @@ typedef struct structFormulaInstruction {
 		Daata object;
 		InterpreterVariable variable;
 	} content;
-} *FormulaInstruction;
+};
 
-static FormulaInstruction lexan, parse;
-static integer ilabel, ilexan, iparse, numberOfInstructions, numberOfStringConstants;
+static thread_local FormulaInstruction lexan, parse;
+static thread_local integer ilabel, ilexan, iparse, numberOfInstructions, numberOfStringConstants;
 
 enum { NO_SYMBOL_,
 
@@ -406,13 +411,13 @@ static_assert (sizeof (Formula_instructionNames) == (1 + END_) * sizeof (constst
 #define oldread  (-- ilexan)
 
 static void formulaError (conststring32 message, integer position) {
-	static MelderString truncatedExpression;
+	static thread_local MelderString truncatedExpression;
 	MelderString_ncopy (& truncatedExpression, theExpression, position + 1);
 	Melder_throw (message, U":\n« ", truncatedExpression.string);
 }
 
 static integer Formula_hasLanguageName (conststring32 f) {
-	static autoINTVEC index;
+	static thread_local autoINTVEC index;
 	if (NUMisEmpty (index.get())) {
 		index = to_INTVEC (highestInputSymbol);
 		std::sort (index.begin(), index.end(),
@@ -460,7 +465,7 @@ static void Formula_lexan () {
 #define toknumber(g)  lexan [itok]. content.number = (g)
 #define tokmatrix(m)  lexan [itok]. content.object = (m)
 
-	static MelderString token;   // string to collect a symbol name in
+	static thread_local MelderString token;   // string to collect a symbol name in
 #define stringtokon MelderString_empty (& token);
 #define stringtokchar { MelderString_appendCharacter (& token, kar); newchar; }
 #define stringtokoff (void) 0
@@ -997,7 +1002,7 @@ static void fit (integer symbol) {
 		const conststring32 symbolName2 = Formula_instructionNames [lexan [ilexan]. symbol];
 		const bool needQuotes1 = ! str32chr (symbolName1, U' ');
 		const bool needQuotes2 = ! str32chr (symbolName2, U' ');
-		static MelderString message;
+		static thread_local MelderString message;
 		MelderString_copy (& message,
 			U"Expected ", ( needQuotes1 ? U"“" : nullptr ), symbolName1, ( needQuotes1 ? U"”" : nullptr ),
 			U", but found ", ( needQuotes2 ? U"“" : nullptr ), symbolName2, ( needQuotes2 ? U"”" : nullptr ));
@@ -1013,7 +1018,7 @@ static bool fitArguments () {
     	return false;   // success: a function call like: myFunction: ...
     const conststring32 symbolName2 = Formula_instructionNames [lexan [ilexan]. symbol];
     const bool needQuotes2 = ! str32chr (symbolName2, U' ');
-    static MelderString message;
+    static thread_local MelderString message;
     MelderString_copy (& message,
 		U"Expected “(” or “:”, but found ", ( needQuotes2 ? U"“" : nullptr ), symbolName2, ( needQuotes2 ? U"”" : nullptr ));
     formulaError (message.string, lexan [ilexan]. position);
@@ -2140,7 +2145,7 @@ static integer praat_findObjectById (integer id) {
 static integer praat_findObjectByName (conststring32 name) {
 	integer IOBJECT;
 	if (*name >= U'A' && *name <= U'Z') {
-		static MelderString buffer;
+		static thread_local MelderString buffer;
 		MelderString_copy (& buffer, name);
 		char32 *spaceLocation = str32chr (buffer.string, U' ');
 		if (! spaceLocation)
@@ -2301,7 +2306,7 @@ static void Formula_print (FormulaInstruction f) {
 	} while (symbol != END_);
 }
 
-void Formula_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize) {
+static void Formula_compileIntoParse (Interpreter interpreter, Daata data, conststring32 expression, bool optimize) {
 	if (interpreter)
 		Melder_assert (interpreter -> owningInterpreterStack);
 	theInterpreter = interpreter;
@@ -2317,10 +2322,10 @@ void Formula_compile (Interpreter interpreter, Daata data, conststring32 express
 		theInterpreter = theLocalInterpreterStack -> interpreters [1].get();
 		theInterpreter -> owningInterpreterStack = theLocalInterpreterStack.get();
 		theInterpreter -> variablesMap. clear ();
+		theInterpreter -> compiledExpressions. clear ();   // they refer to the variables
 	}
 	theSource = data;
 	theExpression = expression;
-	theExpressionType [theLevel] = expressionType;
 	theOptimize = optimize;
 	if (! lexan) {
 		lexan = Melder_calloc_f (structFormulaInstruction, Formula_MAXIMUM_STACK_SIZE);
@@ -2365,6 +2370,163 @@ void Formula_compile (Interpreter interpreter, Daata data, conststring32 express
 	if (Melder_debug == 17) Formula_print (parse);
 }
 
+static bool symbolHasOwnString (integer symbol) {
+	return symbol == STRING_ || symbol == VARIABLE_NAME_ ||
+			symbol == INDEXED_NUMERIC_VARIABLE_ || symbol == INDEXED_STRING_VARIABLE_ || symbol == CALL_;
+}
+
+/*
+	The symbols that may occur in a pointwise formula (see FormulaProgram_isPointwise () in Formula.h).
+	Everything else is suspect: random numbers depend on the order of evaluation,
+	indexing into `self` may read cells that other threads are writing,
+	and most other functions touch the interpreter, the object list, files or the Info window.
+*/
+static bool symbolIsPointwise (integer symbol) {
+	switch (symbol) {
+		case NUMBER_: case ROW_: case COL_: case X_: case Y_: case SELF0_: case NUMERIC_VARIABLE_:
+		case TRUE_: case FALSE_: case GOTO_: case IFTRUE_: case IFFALSE_: case LABEL_:
+		case NOT_: case EQ_: case NE_: case LE_: case LT_: case GE_: case GT_:
+		case ADD_: case SUB_: case MUL_: case RDIV_: case IDIV_: case MOD_: case MINUS_: case POWER_: case SQR_:
+		case ABS_: case ROUND_: case FLOOR_: case CEILING_: case RECTIFY_: case SQRT_:
+		case SIN_: case COS_: case TAN_: case ARCSIN_: case ARCCOS_: case ARCTAN_: case SINC_: case SINCPI_:
+		case EXP_: case SINH_: case COSH_: case TANH_: case ARCSINH_: case ARCCOSH_: case ARCTANH_:
+		case SIGMOID_: case INV_SIGMOID_: case ERF_: case ERFC_: case GAUSS_P_: case GAUSS_Q_: case INV_GAUSS_Q_:
+		case LOG2_: case LN_: case LOG10_: case LN_GAMMA_:
+		case HERTZ_TO_BARK_: case BARK_TO_HERTZ_: case PHON_TO_DIFFERENCE_LIMENS_: case DIFFERENCE_LIMENS_TO_PHON_:
+		case HERTZ_TO_MEL_: case MEL_TO_HERTZ_: case HERTZ_TO_SEMITONES_: case SEMITONES_TO_HERTZ_:
+		case ERB_: case HERTZ_TO_ERB_: case ERB_TO_HERTZ_:
+		case ARCTAN2_: case CHI_SQUARE_P_: case CHI_SQUARE_Q_: case INCOMPLETE_GAMMAP_: case INV_CHI_SQUARE_Q_:
+		case STUDENT_P_: case STUDENT_Q_: case INV_STUDENT_Q_: case BETA_: case BETA2_: case BESSEL_I_: case BESSEL_K_:
+		case LN_BETA_: case SOUND_PRESSURE_TO_PHON_:
+		case FISHER_P_: case FISHER_Q_: case INV_FISHER_Q_: case BINOMIAL_P_: case BINOMIAL_Q_:
+		case INCOMPLETE_BETA_: case INV_BINOMIAL_P_: case INV_BINOMIAL_Q_:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+	The symbols that FormulaProgram_runRow () can handle,
+	with the change in the depth of the stack that each of them causes.
+	Conditionals are absent, because their jumps would have to be taken for each column separately.
+*/
+static bool symbolIsVectorizable (integer symbol, integer *out_stackEffect) {
+	switch (symbol) {
+		case NUMBER_: case ROW_: case COL_: case X_: case Y_: case SELF0_: case NUMERIC_VARIABLE_:
+		case TRUE_: case FALSE_:
+			*out_stackEffect = +1;
+			return true;
+		case NOT_: case MINUS_: case SQR_:
+		case ABS_: case ROUND_: case FLOOR_: case CEILING_: case RECTIFY_: case SQRT_:
+		case SIN_: case COS_: case TAN_: case ARCSIN_: case ARCCOS_: case ARCTAN_:
+		case EXP_: case SINH_: case COSH_: case TANH_: case ARCSINH_: case ARCCOSH_: case ARCTANH_:
+		case LOG2_: case LN_: case LOG10_: case SIGMOID_: case INV_SIGMOID_:
+		case SINC_: case SINCPI_: case ERF_: case ERFC_: case GAUSS_P_: case GAUSS_Q_: case INV_GAUSS_Q_: case LN_GAMMA_:
+		case HERTZ_TO_BARK_: case BARK_TO_HERTZ_: case PHON_TO_DIFFERENCE_LIMENS_: case DIFFERENCE_LIMENS_TO_PHON_:
+		case HERTZ_TO_MEL_: case MEL_TO_HERTZ_: case HERTZ_TO_SEMITONES_: case SEMITONES_TO_HERTZ_:
+		case ERB_: case HERTZ_TO_ERB_: case ERB_TO_HERTZ_:
+			*out_stackEffect = 0;
+			return true;
+		case EQ_: case NE_: case LE_: case LT_: case GE_: case GT_:
+		case ADD_: case SUB_: case MUL_: case RDIV_: case IDIV_: case MOD_: case POWER_:
+		case ARCTAN2_: case CHI_SQUARE_P_: case CHI_SQUARE_Q_: case INCOMPLETE_GAMMAP_: case INV_CHI_SQUARE_Q_:
+		case STUDENT_P_: case STUDENT_Q_: case INV_STUDENT_Q_: case BETA_: case BETA2_: case LN_BETA_:
+		case SOUND_PRESSURE_TO_PHON_:
+			*out_stackEffect = -1;
+			return true;
+		default:
+			return false;
+	}
+}
+
+Thing_implement (FormulaProgram, Thing, 0);
+
+void structFormulaProgram :: v9_destroy () noexcept {
+	if (our instructions) {
+		for (integer i = 1; i <= our numberOfInstructions + 1; i ++)
+			if (symbolHasOwnString (our instructions [i]. symbol))
+				Melder_free (our instructions [i]. content.string);
+		Melder_free (our instructions);
+	}
+	FormulaProgram_Parent :: v9_destroy ();
+}
+
+autoFormulaProgram FormulaProgram_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize) {
+	Formula_compileIntoParse (interpreter, data, expression, optimize);
+	autoFormulaProgram me = Thing_new (FormulaProgram);
+	my interpreter = theInterpreter;   // which may have been replaced with the local interpreter
+	my source = data;
+	my expressionType = expressionType;
+	my optimize = optimize;
+	my numberOfInstructions = numberOfInstructions;
+	/*
+		Copy the parse, including its terminating END_.
+		The strings in `parse` are owned by `lexan` or by interpreter variables,
+		so we need our own copies.
+	*/
+	my instructions = Melder_calloc (structFormulaInstruction, 1 + numberOfInstructions + 1);
+	my isPointwise = true;
+	for (integer i = 1; i <= numberOfInstructions + 1; i ++) {
+		const integer symbol = parse [i]. symbol;
+		autostring32 ownString = ( symbolHasOwnString (symbol) ? Melder_dup (parse [i]. content.string) : autostring32 () );
+		my instructions [i] = parse [i];
+		if (ownString)
+			my instructions [i]. content.string = ownString.transfer();
+		if (i <= numberOfInstructions && ! symbolIsPointwise (symbol))
+			my isPointwise = false;
+	}
+	Melder_assert (my instructions [numberOfInstructions + 1]. symbol == END_);
+	/*
+		Object names are resolved by the lexical analyser,
+		and object numbers by the optimizer.
+	*/
+	my isReusable = true;
+	for (integer itok = 1; lexan [itok]. symbol != END_; itok ++)
+		if (lexan [itok]. symbol == MATRIX_ || lexan [itok]. symbol == MATRIX_STR_)
+			my isReusable = false;
+	for (integer i = 1; i <= numberOfInstructions; i ++)
+		if (my instructions [i]. symbol == OBJECT_)
+			my isReusable = false;
+	/*
+		Can the program be run a row at a time?
+	*/
+	my isVectorizable = ( my isPointwise && expressionType == kFormula_EXPRESSION_TYPE_NUMERIC );
+	integer stackDepth = 0;
+	for (integer i = 1; i <= numberOfInstructions && my isVectorizable; i ++) {
+		integer stackEffect;
+		if (! symbolIsVectorizable (my instructions [i]. symbol, & stackEffect)) {
+			my isVectorizable = false;
+			break;
+		}
+		stackDepth += stackEffect;
+		Melder_assert (stackDepth >= 1);
+		if (stackDepth > my maximumRowStackDepth)
+			my maximumRowStackDepth = stackDepth;
+	}
+	if (my isVectorizable)
+		Melder_assert (stackDepth == 1);
+	return me;
+}
+
+bool FormulaProgram_isPointwise (FormulaProgram me) {
+	return my isPointwise && my expressionType == kFormula_EXPRESSION_TYPE_NUMERIC;
+}
+
+bool FormulaProgram_isReusable (FormulaProgram me) {
+	return my isReusable;
+}
+
+bool FormulaProgram_isVectorizable (FormulaProgram me) {
+	return my isVectorizable;
+}
+
+static thread_local autoFormulaProgram theCompiledFormula;   // the result of the latest Formula_compile () on this thread
+
+void Formula_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize) {
+	theCompiledFormula = FormulaProgram_compile (interpreter, data, expression, expressionType, optimize);
+}
+
 /*
 	Running.
 */
@@ -2380,12 +2542,26 @@ conststring32 structStackel :: whichText () {
 		U"???";
 }
 
-static integer programPointer;
+/*
+	The instructions of the FormulaProgram that is being run.
+*/
+static thread_local FormulaInstruction theProgram;
+static thread_local integer theProgramLength;
+static thread_local integer programPointer;
 
-static Stackel theStack;
-static integer stackPointer, stackPointerMax;
+/*
+	Each thread has a single stack, which is shared by nested runs (e.g. via `evaluate`):
+	a nested run starts just above the highest element that the run it is nested in has used so far,
+	so that it cannot overwrite anything that is still needed after it returns.
+*/
+static thread_local Stackel theStackMemory;
+static thread_local Stackel theStack;   // base-1; the part of theStackMemory used by the current run
+static thread_local integer stackPointer, stackPointerMax, theStackCapacity;
 #define pop  & theStack [stackPointer --]
 #define topOfStack  & theStack [stackPointer]
+inline static double numberForStack (const double x) {
+	return isdefined (x) ? x : undefined;   // inf becomes NaN
+}
 inline static void pushNumber (const double x) {
 	/* inline runs 10 to 20 percent faster; here's the test script:
 		stopwatch
@@ -2395,18 +2571,18 @@ inline static void pushNumber (const double x) {
 	 * Mac: 3.76 -> 3.20 seconds
 	 */
 	if (++ stackPointer > stackPointerMax)
-		if (++ stackPointerMax > Formula_MAXIMUM_STACK_SIZE)
+		if (++ stackPointerMax > theStackCapacity)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
 	const Stackel stackel = & theStack [stackPointer];
 	stackel -> reset();
 	stackel -> which = Stackel_NUMBER;
-	stackel -> number = ( isdefined (x) ? x : undefined );
+	stackel -> number = numberForStack (x);
 	//stackel -> number = x;   // this one would be 2 percent faster
 	//stackel -> owned = true;   // superfluous, because never checked (2020-12-20)
 }
 static void pushNumericVector (autoVEC x) {
 	if (++ stackPointer > stackPointerMax)
-		if (++ stackPointerMax > Formula_MAXIMUM_STACK_SIZE)
+		if (++ stackPointerMax > theStackCapacity)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
 	const Stackel stackel = & theStack [stackPointer];
 	stackel -> reset();
@@ -2416,7 +2592,7 @@ static void pushNumericVector (autoVEC x) {
 }
 static void pushNumericVectorReference (VEC x) {
 	if (++ stackPointer > stackPointerMax)
-		if (++ stackPointerMax > Formula_MAXIMUM_STACK_SIZE)
+		if (++ stackPointerMax > theStackCapacity)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
 	const Stackel stackel = & theStack [stackPointer];
 	stackel -> reset();
@@ -2426,7 +2602,7 @@ static void pushNumericVectorReference (VEC x) {
 }
 static void pushNumericMatrix (autoMAT x) {
 	if (++ stackPointer > stackPointerMax)
-		if (++ stackPointerMax > Formula_MAXIMUM_STACK_SIZE)
+		if (++ stackPointerMax > theStackCapacity)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
 	const Stackel stackel = & theStack [stackPointer];
 	stackel -> reset();
@@ -2436,7 +2612,7 @@ static void pushNumericMatrix (autoMAT x) {
 }
 static void pushNumericMatrixReference (MAT x) {
 	if (++ stackPointer > stackPointerMax)
-		if (++ stackPointerMax > Formula_MAXIMUM_STACK_SIZE)
+		if (++ stackPointerMax > theStackCapacity)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
 	const Stackel stackel = & theStack [stackPointer];
 	stackel -> reset();
@@ -2446,7 +2622,7 @@ static void pushNumericMatrixReference (MAT x) {
 }
 static void pushString (autostring32 x) {
 	if (++ stackPointer > stackPointerMax)
-		if (++ stackPointerMax > Formula_MAXIMUM_STACK_SIZE)
+		if (++ stackPointerMax > theStackCapacity)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
 	const Stackel stackel = & theStack [stackPointer];
 	//stackel -> reset();   // incorporated in next statement
@@ -2455,7 +2631,7 @@ static void pushString (autostring32 x) {
 }
 static void pushStringVector (autoSTRVEC x) {
 	if (++ stackPointer > stackPointerMax)
-		if (++ stackPointerMax > Formula_MAXIMUM_STACK_SIZE)
+		if (++ stackPointerMax > theStackCapacity)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
 	const Stackel stackel = & theStack [stackPointer];
 	stackel -> reset();
@@ -2465,7 +2641,7 @@ static void pushStringVector (autoSTRVEC x) {
 }
 static void pushStringVectorReference (STRVEC x) {
 	if (++ stackPointer > stackPointerMax)
-		if (++ stackPointerMax > Formula_MAXIMUM_STACK_SIZE)
+		if (++ stackPointerMax > theStackCapacity)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
 	const Stackel stackel = & theStack [stackPointer];
 	stackel -> reset();
@@ -2475,7 +2651,7 @@ static void pushStringVectorReference (STRVEC x) {
 }
 static void pushObject (Daata object) {
 	if (++ stackPointer > stackPointerMax)
-		if (++ stackPointerMax > Formula_MAXIMUM_STACK_SIZE)
+		if (++ stackPointerMax > theStackCapacity)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
 	const Stackel stackel = & theStack [stackPointer];
 	stackel -> reset();
@@ -2485,7 +2661,7 @@ static void pushObject (Daata object) {
 }
 static void pushVariable (InterpreterVariable var) {
 	if (++ stackPointer > stackPointerMax)
-		if (++ stackPointerMax > Formula_MAXIMUM_STACK_SIZE)
+		if (++ stackPointerMax > theStackCapacity)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
 	const Stackel stackel = & theStack [stackPointer];
 	stackel -> reset();
@@ -3560,7 +3736,7 @@ static void do_function_n_n (double (*f) (double)) {
 	if (x->which == Stackel_NUMBER) {
 		pushNumber (isundef (x->number) ? undefined : f (x->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires a numeric argument, not ", x->whichText(), U".");
 	}
 }
@@ -3580,7 +3756,7 @@ static void do_functionvec_n_n (double (*f) (double)) {
 			x->owned = true;
 		}
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires a numeric vector argument, not ", x->whichText(), U".");
 	}
 }
@@ -3607,7 +3783,7 @@ static void do_softmax_VEC () {
 		for (integer i = 1; i <= numberOfElements; i ++)
 			x->numericVector [i] /= (double) sum;
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires a numeric vector argument, not ", x->whichText(), U".");
 	}
 }
@@ -3636,7 +3812,7 @@ static void do_softmaxPerRow_MAT () {
 				x->numericMatrix [irow] [icol] /= (double) sum;
 		}
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires a numeric matrix argument, not ", x->whichText(), U".");
 	}
 }
@@ -3709,6 +3885,12 @@ static void do_##function##_MAT () { \
 		Melder_throw (U"The function " #function "## requires a matrix argument, not ", \
 				x->whichText(), U"."); \
 	} \
+} \
+static void do_##function##_ROW (VEC const& x) { \
+	for (integer i = 1; i <= x.size; i ++) { \
+		const double xvalue = x [i]; \
+		x [i] = numberForStack (formula); \
+	} \
 }
 DO_NUM_WITH_TENSORS (abs, fabs (xvalue), U"Cannot take the absolute value (abs) of ")
 DO_NUM_WITH_TENSORS (round, floor (xvalue + 0.5), U"Cannot round ")
@@ -3873,7 +4055,7 @@ static void do_function_dd_d (double (*f) (double, double)) {
 	if (x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined : f (x->number, y->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3882,7 +4064,7 @@ static void do_function_VECdd_d (double (*f) (double, double)) {
 	const Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	Melder_require (narg->number == 3,
-		U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three arguments.");
+		U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol], U" requires three arguments.");
 	const Stackel y = pop, x = pop, a = pop;
 	if ((a->which == Stackel_NUMERIC_VECTOR || a->which == Stackel_NUMBER) && x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		const integer numberOfElements = ( a->which == Stackel_NUMBER ? Melder_iround (a->number) : a->numericVector.size );
@@ -3891,7 +4073,7 @@ static void do_function_VECdd_d (double (*f) (double, double)) {
 			newData [ielem] = f (x->number, y->number);
 		pushNumericVector (newData.move());
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires either three numeric arguments, or one vector argument and two numeric arguments, not ",
 			a->whichText(), U", ", x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3910,7 +4092,7 @@ static void do_function_MATdd_d (double (*f) (double, double)) {
 					newData [irow] [icol] = f (x->number, y->number);
 			pushNumericMatrix (newData.move());
 		} else {
-			Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+			Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 				U" requires one matrix argument and two numeric arguments, not ",
 				model->whichText(), U", ", x->whichText(), U" and ", y->whichText(), U".");
 		}
@@ -3925,19 +4107,19 @@ static void do_function_MATdd_d (double (*f) (double, double)) {
 					newData [irow] [icol] = f (x->number, y->number);
 			pushNumericMatrix (newData.move());
 		} else {
-			Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+			Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 				U" requires four numeric arguments, not ",
 				nrow->whichText(), U", ", ncol->whichText(), U", ", x->whichText(), U" and ", y->whichText(), U".");
 		}
 	} else
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three or four arguments.");
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol], U" requires three or four arguments.");
 }
 
 static void do_function_VECll_l (integer (*f) (integer, integer)) {
 	const Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	Melder_require (narg-> number == 3,
-		U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three arguments.");
+		U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol], U" requires three arguments.");
 	const Stackel y = pop, x = pop, a = pop;
 	if ((a->which == Stackel_NUMERIC_VECTOR || a->which == Stackel_NUMBER) && x->which == Stackel_NUMBER) {
 		const integer numberOfElements = ( a->which == Stackel_NUMBER ? Melder_iround (a->number) : a->numericVector.size );
@@ -3946,7 +4128,7 @@ static void do_function_VECll_l (integer (*f) (integer, integer)) {
 			newData [ielem] = f (Melder_iround (x->number), Melder_iround (y->number));
 		pushNumericVector (newData.move());
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires either three numeric arguments, or one vector argument and two numeric arguments, not ",
 			a->whichText(), U", ", x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3955,7 +4137,7 @@ static void do_function_MATll_l (integer (*f) (integer, integer)) {
 	const Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	Melder_require (narg->number == 3,
-		U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three arguments.");
+		U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol], U" requires three arguments.");
 	const Stackel y = pop, x = pop, a = pop;
 	if (a->which == Stackel_NUMERIC_MATRIX && x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		const integer numberOfRows = a->numericMatrix.nrow;
@@ -3966,7 +4148,7 @@ static void do_function_MATll_l (integer (*f) (integer, integer)) {
 				newData [irow] [icol] = f (Melder_iround (x->number), Melder_iround (y->number));
 		pushNumericMatrix (newData.move());
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires one matrix argument and two numeric arguments, not ",
 			a->whichText(), U", ", x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3977,7 +4159,7 @@ static void do_function_dl_d (double (*f) (double, integer)) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined :
 			f (x->number, Melder_iround (y->number)));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3988,7 +4170,7 @@ static void do_function_ld_d (double (*f) (integer, double)) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined :
 			f (Melder_iround (x->number), y->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3999,7 +4181,7 @@ static void do_function_ll_l (integer (*f) (integer, integer)) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined :
 			f (Melder_iround (x->number), Melder_iround (y->number)));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -4032,7 +4214,7 @@ static void do_function_ddd_d (double (*f) (double, double, double)) {
 		pushNumber (isundef (x->number) || isundef (y->number) || isundef (z->number) ? undefined :
 			f (x->number, y->number, z->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires three numeric arguments, not ", x->whichText(), U", ",
 			y->whichText(), U", and ", z->whichText(), U".");
 	}
@@ -5395,7 +5577,7 @@ static void do_numberOfRows () {
 	if (array->which == Stackel_NUMERIC_MATRIX) {
 		pushNumber (array->numericMatrix.nrow);
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires a matrix argument, not ", array->whichText(), U".");
 	}
 }
@@ -5408,7 +5590,7 @@ static void do_numberOfColumns () {
 	if (array->which == Stackel_NUMERIC_MATRIX) {
 		pushNumber (array->numericMatrix.ncol);
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires a matrix argument, not ", array->whichText(), U".");
 	}
 }
@@ -5877,7 +6059,7 @@ static void do_upperSnakeCase_STR () {
 	}
 }
 static void do_numericVectorElement () {
-	InterpreterVariable vector = parse [programPointer]. content.variable;
+	InterpreterVariable vector = theProgram [programPointer]. content.variable;
 	const Stackel element = pop;
 	Melder_require (element->which == Stackel_NUMBER,
 		U"In vector indexing, the index should be a number, not ", element->whichText(), U".");
@@ -5893,7 +6075,7 @@ static void do_numericVectorElement () {
 	pushNumber (vector->numericVectorValue [ielement]);
 }
 static void do_numericMatrixElement () {
-	InterpreterVariable matrix = parse [programPointer]. content.variable;
+	InterpreterVariable matrix = theProgram [programPointer]. content.variable;
 	const Stackel column = pop;
 	Melder_require (column->which == Stackel_NUMBER,
 		U"In matrix indexing, the column index should be a number, not ", column->whichText(), U".");
@@ -5921,7 +6103,7 @@ static void do_numericMatrixElement () {
 	pushNumber (matrix->numericMatrixValue [irow] [icolumn]);
 }
 static void do_stringVectorElement () {
-	InterpreterVariable vector = parse [programPointer]. content.variable;
+	InterpreterVariable vector = theProgram [programPointer]. content.variable;
 	const Stackel element = pop;
 	Melder_require (element->which == Stackel_NUMBER,
 		U"In vector indexing, the index should be a number, not ", element->whichText(), U".");
@@ -5942,8 +6124,8 @@ static void do_indexedNumericVariable () {
 	const integer nindex = Melder_iround (narg->number);
 	Melder_require (nindex >= 1,
 		U"Indexed variables require at least one index.");
-	char32 *indexedVariableName = parse [programPointer]. content.string;
-	static MelderString totalVariableName;
+	char32 *indexedVariableName = theProgram [programPointer]. content.string;
+	static thread_local MelderString totalVariableName;
 	MelderString_copy (& totalVariableName, indexedVariableName, U"[");
 	stackPointer -= nindex;
 	for (int iindex = 1; iindex <= nindex; iindex ++) {
@@ -5967,8 +6149,8 @@ static void do_indexedStringVariable () {
 	const integer nindex = Melder_iround (narg->number);
 	Melder_require (nindex >= 1,
 		U"Indexed variables require at least one index.");
-	char32 *indexedVariableName = parse [programPointer]. content.string;
-	static MelderString totalVariableName;
+	char32 *indexedVariableName = theProgram [programPointer]. content.string;
+	static thread_local MelderString totalVariableName;
 	MelderString_copy (& totalVariableName, indexedVariableName, U"[");
 	stackPointer -= nindex;
 	for (int iindex = 1; iindex <= nindex; iindex ++) {
@@ -6367,7 +6549,7 @@ static void do_index_regex (int backward) {
 			}
 		}
 	} else {
-		Melder_throw (U"The function “", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function “", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U"” requires two strings, not ", s->whichText(), U" and ", t->whichText(), U".");
 	}
 }
@@ -6377,7 +6559,7 @@ static void do_stringMatchesCriterion (kMelder_string criterion, bool caseSensit
 		const bool result = Melder_stringMatchesCriterion (s->getString(), criterion, t->getString(), caseSensitive);
 		pushNumber (result);
 	} else {
-		Melder_throw (U"The function “", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function “", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U"” requires two strings, not ", s->whichText(), U" and ", t->whichText(), U".");
 	}
 }
@@ -6420,7 +6602,7 @@ static void do_extractNumber () {
 			}
 		}
 	} else {
-		Melder_throw (U"The function “", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function “", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U"” requires two strings, not ", s->whichText(), U" and ", t->whichText(), U".");
 	}
 }
@@ -6453,7 +6635,7 @@ static void do_extractText_STR (bool singleWord) {
 		}
 		pushString (result.move());
 	} else {
-		Melder_throw (U"The function “", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function “", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U"” requires two strings, not ", s->whichText(), U" and ", t->whichText(), U".");
 	}
 }
@@ -8600,7 +8782,7 @@ static void do_objectCell0 (integer irow, integer icol) {
 	}
 }
 static void do_matrix0 (integer irow, integer icol) {
-	const Daata thee = parse [programPointer]. content.object;
+	const Daata thee = theProgram [programPointer]. content.object;
 	if (thy v_hasGetCell ()) {
 		pushNumber (thy v_getCell ());
 	} else if (thy v_hasGetVector ()) {
@@ -8688,7 +8870,7 @@ static void do_objectCell1 (integer irow) {
 	}
 }
 static void do_matrix1 (integer irow) {
-	const Daata thee = parse [programPointer]. content.object;
+	const Daata thee = theProgram [programPointer]. content.object;
 	const Stackel column = pop;
 	const integer icol = Stackel_getColumnNumber (column, thee);
 	if (thy v_hasGetVector ()) {
@@ -8724,7 +8906,7 @@ static void do_objectCell1_STR (integer irow) {
 	}
 }
 static void do_matrix1_STR (integer irow) {
-	const Daata thee = parse [programPointer]. content.object;
+	const Daata thee = theProgram [programPointer]. content.object;
 	const Stackel column = pop;
 	const integer icol = Stackel_getColumnNumber (column, thee);
 	if (thy v_hasGetVectorStr ()) {
@@ -8773,7 +8955,7 @@ static void do_objectCell2 () {
 	pushNumber (thy v_getMatrix (irow, icol));
 }
 static void do_matrix2 () {
-	const Daata thee = parse [programPointer]. content.object;
+	const Daata thee = theProgram [programPointer]. content.object;
 	const Stackel column = pop, row = pop;
 	const integer irow = Stackel_getRowNumber (row, thee);
 	const integer icol = Stackel_getColumnNumber (column, thee);
@@ -8791,7 +8973,7 @@ static void do_objectCell2_STR () {
 	pushString (Melder_dup (thy v_getMatrixStr (irow, icol)));
 }
 static void do_matrix2_STR () {
-	const Daata thee = parse [programPointer]. content.object;
+	const Daata thee = theProgram [programPointer]. content.object;
 	const Stackel column = pop, row = pop;
 	const integer irow = Stackel_getRowNumber (row, thee);
 	const integer icol = Stackel_getColumnNumber (column, thee);
@@ -8839,7 +9021,7 @@ static void do_objectLocation0 (integer irow, integer icol) {
 	}
 }
 static void do_function0 (integer irow, integer icol) {
-	const Daata thee = parse [programPointer]. content.object;
+	const Daata thee = theProgram [programPointer]. content.object;
 	if (thy v_hasGetFunction0 ()) {
 		pushNumber (thy v_getFunction0 ());
 	} else if (thy v_hasGetFunction1 ()) {
@@ -8923,7 +9105,7 @@ static void do_objectLocation1 (integer irow) {
 	}
 }
 static void do_function1 (integer irow) {
-	const Daata thee = parse [programPointer]. content.object;
+	const Daata thee = theProgram [programPointer]. content.object;
 	const Stackel x = pop;
 	if (x->which == Stackel_NUMBER) {
 		if (thy v_hasGetFunction1 ()) {
@@ -8972,7 +9154,7 @@ static void do_objectLocation2 () {
 	}
 }
 static void do_function2 () {
-	const Daata thee = parse [programPointer]. content.object;
+	const Daata thee = theProgram [programPointer]. content.object;
 	const Stackel y = pop, x = pop;
 	if (x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		if (! thy v_hasGetFunction2 ())
@@ -8983,7 +9165,7 @@ static void do_function2 () {
 	}
 }
 static void do_row_STR () {
-	const Daata thee = parse [programPointer]. content.object;
+	const Daata thee = theProgram [programPointer]. content.object;
 	const Stackel row = pop;
 	const integer irow = Stackel_getRowNumber (row, thee);
 	autostring32 result = Melder_dup (thy v_getRowStr (irow));
@@ -8992,7 +9174,7 @@ static void do_row_STR () {
 	pushString (result.move());
 }
 static void do_col_STR () {
-	const Daata thee = parse [programPointer]. content.object;
+	const Daata thee = theProgram [programPointer]. content.object;
 	const Stackel col = pop;
 	const integer icol = Stackel_getColumnNumber (col, thee);
 	autostring32 result = Melder_dup (thy v_getColStr (icol));
@@ -9005,18 +9187,44 @@ static double NUMerf (double x) {
 	return 1.0 - NUMerfcc (x);
 }
 
-void Formula_run (integer row, integer col, Formula_Result *result) {
-	FormulaInstruction f = parse;
-	programPointer = 1;   // first symbol of the program
-	if (! theStack) {
-		theStack = Melder_calloc_f (structStackel, 1+Formula_MAXIMUM_STACK_SIZE);
-		if (! theStack)
+static void Formula_runInstructions (const FormulaInstruction f, const integer numberOfInstructionsToRun,
+	const int expressionType, const integer row, const integer col, Formula_Result *result)
+{
+	if (! theStackMemory) {
+		theStackMemory = Melder_calloc_f (structStackel, 1+Formula_MAXIMUM_STACK_SIZE);
+		if (! theStackMemory)
 			Melder_throw (U"Out of memory during formula computation.");
 	}
+	/*
+		Save the state of the run that we may be nested in.
+	*/
+	const FormulaInstruction outerProgram = theProgram;
+	const integer outerProgramLength = theProgramLength, outerProgramPointer = programPointer;
+	const Stackel outerStack = theStack;
+	const integer outerStackPointer = stackPointer, outerStackPointerMax = stackPointerMax, outerStackCapacity = theStackCapacity;
+	if (outerStack) {
+		theStack = outerStack + outerStackPointerMax;
+		theStackCapacity = outerStackCapacity - outerStackPointerMax;
+	} else {
+		theStack = theStackMemory;
+		theStackCapacity = Formula_MAXIMUM_STACK_SIZE;
+	}
+	auto restoreOuterRun = [&] () {
+		theProgram = outerProgram;
+		theProgramLength = outerProgramLength;
+		programPointer = outerProgramPointer;
+		theStack = outerStack;
+		stackPointer = outerStackPointer;
+		stackPointerMax = outerStackPointerMax;
+		theStackCapacity = outerStackCapacity;
+	};
+	theProgram = f;
+	theProgramLength = numberOfInstructionsToRun;
+	programPointer = 1;   // first symbol of the program
 	stackPointer = 0;   // start new stack
 	stackPointerMax = 0;   // start new stack
 	try {
-		while (programPointer <= numberOfInstructions) {
+		while (programPointer <= theProgramLength) {
 			integer symbol;
 				switch (symbol = f [programPointer]. symbol) {
 
@@ -9515,7 +9723,7 @@ CASE_NUM_WITH_TENSORS (LOG10_, do_log10)
 } break; case STRING_ARRAY_VARIABLE_: {
 	InterpreterVariable var = f [programPointer]. content.variable;
 	pushStringVectorReference (var -> stringArrayValue.get());
-} break; default: Melder_throw (U"Symbol “", Formula_instructionNames [parse [programPointer]. symbol], U"” without action.");
+} break; default: Melder_throw (U"Symbol “", Formula_instructionNames [theProgram [programPointer]. symbol], U"” without action.");
 			} // endswitch
 			programPointer ++;
 		} // endwhile
@@ -9525,7 +9733,7 @@ CASE_NUM_WITH_TENSORS (LOG10_, do_log10)
 			Move the result from the stack to `result`.
 		*/
 		result -> reset();
-		if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC) {
+		if (expressionType == kFormula_EXPRESSION_TYPE_NUMERIC) {
 			if (theStack [1]. which == Stackel_STRING)
 				Melder_throw (U"Found a string expression instead of a numeric expression.");
 			if (theStack [1]. which == Stackel_NUMERIC_VECTOR)
@@ -9537,7 +9745,7 @@ CASE_NUM_WITH_TENSORS (LOG10_, do_log10)
 			Melder_assert (theStack [1]. which == Stackel_NUMBER);
 			result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC;
 			result -> numericResult = theStack [1]. number;
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_STRING) {
+		} else if (expressionType == kFormula_EXPRESSION_TYPE_STRING) {
 			if (theStack [1]. which == Stackel_NUMBER)
 				Melder_throw (U"Found a numeric expression (value ", theStack [1]. number, U") instead of a string expression.");
 			if (theStack [1]. which == Stackel_NUMERIC_VECTOR)
@@ -9552,7 +9760,7 @@ CASE_NUM_WITH_TENSORS (LOG10_, do_log10)
 			result -> stringResult = theStack [1]. moveString();
 			Melder_assert (theStack [1]. which == Stackel_STRING);
 			Melder_assert (! theStack [1]. getString());
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR) {
+		} else if (expressionType == kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR) {
 			if (theStack [1]. which == Stackel_NUMBER)
 				Melder_throw (U"Found a numeric expression instead of a vector expression.");
 			if (theStack [1]. which == Stackel_STRING)
@@ -9566,7 +9774,7 @@ CASE_NUM_WITH_TENSORS (LOG10_, do_log10)
 			result -> numericVectorResult = theStack [1]. numericVector;
 			result -> owned = theStack [1]. owned;
 			theStack [1]. owned = false;
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX) {
+		} else if (expressionType == kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX) {
 			if (theStack [1]. which == Stackel_NUMBER)
 				Melder_throw (U"Found a numeric expression instead of a matrix expression.");
 			if (theStack [1]. which == Stackel_STRING)
@@ -9580,7 +9788,7 @@ CASE_NUM_WITH_TENSORS (LOG10_, do_log10)
 			result -> numericMatrixResult = theStack [1]. numericMatrix;
 			result -> owned = theStack [1]. owned;
 			theStack [1]. owned = false;
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_STRING_ARRAY) {
+		} else if (expressionType == kFormula_EXPRESSION_TYPE_STRING_ARRAY) {
 			if (theStack [1]. which == Stackel_NUMBER)
 				Melder_throw (U"Found a numeric expression instead of a string vector expression.");
 			if (theStack [1]. which == Stackel_STRING)
@@ -9595,7 +9803,7 @@ CASE_NUM_WITH_TENSORS (LOG10_, do_log10)
 			result -> owned = theStack [1]. owned;
 			theStack [1]. owned = false;
 		} else {
-			Melder_assert (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_UNKNOWN);
+			Melder_assert (expressionType == kFormula_EXPRESSION_TYPE_UNKNOWN);
 			if (theStack [1]. which == Stackel_NUMBER) {
 				result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC;
 				result -> numericResult = theStack [1]. number;
@@ -9629,12 +9837,14 @@ CASE_NUM_WITH_TENSORS (LOG10_, do_log10)
 		*/
 		for (stackPointer = stackPointerMax; stackPointer > 0; stackPointer --)
 			theStack [stackPointer]. reset();
+		restoreOuterRun ();
 	} catch (MelderError) {
 		/*
 			Clean up the stack (theStack [1] has probably not been disowned).
 		*/
 		for (stackPointer = stackPointerMax; stackPointer > 0; stackPointer --)
 			theStack [stackPointer]. reset();
+		restoreOuterRun ();
 		if (Melder_hasError (U"Script exited.")) {
 			throw;
 		} else {
@@ -9643,4 +9853,275 @@ CASE_NUM_WITH_TENSORS (LOG10_, do_log10)
 	}
 }
 
+void Formula_run (integer row, integer col, Formula_Result *result) {
+	/*
+		While running, the formula may compile other formulas (e.g. via `evaluate` or `runScript`),
+		so we hold on to it ourselves, and afterwards reinstate it as the latest compiled formula.
+	*/
+	autoFormulaProgram program = theCompiledFormula.move();
+	Melder_assert (program);
+	try {
+		FormulaProgram_run (program.get(), row, col, result);
+	} catch (MelderError) {
+		theCompiledFormula = program.move();
+		throw;
+	}
+	theCompiledFormula = program.move();
+}
+
+void FormulaProgram_run (FormulaProgram me, integer row, integer col, Formula_Result *result) {
+	/*
+		The run-time functions find the interpreter and the object in global (though thread-local) variables,
+		which may belong to a different formula (e.g. to the one that calls us via `evaluate`).
+	*/
+	const Interpreter outerInterpreter = theInterpreter;
+	const Daata outerSource = theSource;
+	const bool outerOptimize = theOptimize;
+	theInterpreter = my interpreter;
+	theSource = my source;
+	theOptimize = my optimize;
+	try {
+		Formula_runInstructions (my instructions, my numberOfInstructions, my expressionType, row, col, result);
+		theInterpreter = outerInterpreter;
+		theSource = outerSource;
+		theOptimize = outerOptimize;
+	} catch (MelderError) {
+		theInterpreter = outerInterpreter;
+		theSource = outerSource;
+		theOptimize = outerOptimize;
+		throw;
+	}
+}
+
+/*
+	Row-at-a-time evaluation.
+
+	Every stack element is a block of up to `blockSize` columns, and every instruction is a loop over that block,
+	so that the interpreter's dispatch is done once per block rather than once per cell,
+	and arithmetic runs in loops that the compiler can vectorize.
+	Each operation follows its scalar counterpart exactly (including which results are turned from inf into undefined),
+	so that the result is the same as with FormulaProgram_run () for each cell.
+*/
+static thread_local autoMAT theRowStack;   // one row per stack element
+
+static void FormulaProgram_runBlock (FormulaProgram me, const integer row, const integer firstColumn, VEC const& result) {
+	const integer n = result.size;
+	integer rowStackPointer = 0;
+	auto pushRow = [&] () -> VEC {
+		return theRowStack.row (++ rowStackPointer). part (1, n);
+	};
+	auto popRow = [&] () -> VEC {
+		return theRowStack.row (rowStackPointer --). part (1, n);
+	};
+	auto topRow = [&] () -> VEC {
+		return theRowStack.row (rowStackPointer). part (1, n);
+	};
+	for (integer instructionNumber = 1; instructionNumber <= my numberOfInstructions; instructionNumber ++) {
+		const structFormulaInstruction& instruction = my instructions [instructionNumber];
+		const integer symbol = instruction. symbol;
+		switch (symbol) {
+			case NUMBER_: {
+				pushRow () <<= numberForStack (instruction. content.number);
+			} break; case TRUE_: {
+				pushRow () <<= 1.0;
+			} break; case FALSE_: {
+				pushRow () <<= 0.0;
+			} break; case ROW_: {
+				pushRow () <<= double (row);
+			} break; case COL_: {
+				const VEC x = pushRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = double (firstColumn - 1 + i);
+			} break; case X_: {
+				const Daata source = my source;
+				Melder_require (source -> v_hasGetX (),
+					U"No values for “x” for this object.");
+				const VEC x = pushRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = numberForStack (source -> v_getX (firstColumn - 1 + i));
+			} break; case Y_: {
+				const Daata source = my source;
+				Melder_require (source -> v_hasGetY (),
+					U"No values for “y” for this object.");
+				pushRow () <<= numberForStack (source -> v_getY (row));
+			} break; case SELF0_: {
+				const Daata source = my source;
+				if (! source)
+					Melder_throw (U"The name “self” is restricted to formulas for objects.");
+				const VEC x = pushRow ();
+				if (source -> v_hasGetCell ()) {
+					x <<= numberForStack (source -> v_getCell ());
+				} else if (source -> v_hasGetVector ()) {
+					for (integer i = 1; i <= n; i ++)
+						x [i] = numberForStack (source -> v_getVector (row, firstColumn - 1 + i));
+				} else if (source -> v_hasGetMatrix ()) {
+					for (integer i = 1; i <= n; i ++)
+						x [i] = numberForStack (source -> v_getMatrix (row, firstColumn - 1 + i));
+				} else {
+					Melder_throw (Thing_className (source), U" objects (like self) accept no [] indexing.");
+				}
+			} break; case NUMERIC_VARIABLE_: {
+				pushRow () <<= numberForStack (instruction. content.variable -> numericValue);
+			} break; case NOT_: {
+				const VEC x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = ( isundef (x [i]) ? undefined : x [i] == 0.0 ? 1.0 : 0.0 );
+			} break; case MINUS_: {
+				const VEC x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = - x [i];
+			} break; case SQR_: {
+				const VEC x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = ( isundef (x [i]) ? undefined : numberForStack (x [i] * x [i]) );
+			} break; case ADD_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] += y [i];
+			} break; case SUB_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] -= y [i];
+			} break; case MUL_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] *= y [i];
+			} break; case RDIV_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = numberForStack (x [i] / y [i]);
+			} break; case IDIV_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = numberForStack (floor (x [i] / y [i]));
+			} break; case MOD_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = numberForStack (x [i] - floor (x [i] / y [i]) * y [i]);
+			} break; case POWER_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = ( isundef (x [i]) || isundef (y [i]) ? undefined : numberForStack (pow (x [i], y [i])) );
+			} break; case EQ_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = ( NUMequal (x [i], y [i]) ? 1.0 : 0.0 );
+			} break; case NE_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = ( NUMequal (x [i], y [i]) ? 0.0 : 1.0 );
+			} break; case LE_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = ( isdefined (x [i]) ? isdefined (y [i]) && x [i] <= y [i] : isundef (y [i]) ) ? 1.0 : 0.0;
+			} break; case LT_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = ( isdefined (x [i]) && isdefined (y [i]) && x [i] < y [i] ? 1.0 : 0.0 );
+			} break; case GE_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = ( isdefined (x [i]) ? isdefined (y [i]) && x [i] >= y [i] : isundef (y [i]) ) ? 1.0 : 0.0;
+			} break; case GT_: {
+				const VEC y = popRow (), x = topRow ();
+				for (integer i = 1; i <= n; i ++)
+					x [i] = ( isdefined (x [i]) && isdefined (y [i]) && x [i] > y [i] ? 1.0 : 0.0 );
+			} break;
+			case ABS_: { do_abs_ROW (topRow ()); } break;
+			case ROUND_: { do_round_ROW (topRow ()); } break;
+			case FLOOR_: { do_floor_ROW (topRow ()); } break;
+			case CEILING_: { do_ceiling_ROW (topRow ()); } break;
+			case RECTIFY_: { do_rectify_ROW (topRow ()); } break;
+			case SQRT_: { do_sqrt_ROW (topRow ()); } break;
+			case SIN_: { do_sin_ROW (topRow ()); } break;
+			case COS_: { do_cos_ROW (topRow ()); } break;
+			case TAN_: { do_tan_ROW (topRow ()); } break;
+			case ARCSIN_: { do_arcsin_ROW (topRow ()); } break;
+			case ARCCOS_: { do_arccos_ROW (topRow ()); } break;
+			case ARCTAN_: { do_arctan_ROW (topRow ()); } break;
+			case EXP_: { do_exp_ROW (topRow ()); } break;
+			case SINH_: { do_sinh_ROW (topRow ()); } break;
+			case COSH_: { do_cosh_ROW (topRow ()); } break;
+			case TANH_: { do_tanh_ROW (topRow ()); } break;
+			case ARCSINH_: { do_arcsinh_ROW (topRow ()); } break;
+			case ARCCOSH_: { do_arccosh_ROW (topRow ()); } break;
+			case ARCTANH_: { do_arctanh_ROW (topRow ()); } break;
+			case LOG2_: { do_log2_ROW (topRow ()); } break;
+			case LN_: { do_ln_ROW (topRow ()); } break;
+			case LOG10_: { do_log10_ROW (topRow ()); } break;
+			case SIGMOID_: { do_sigmoid_ROW (topRow ()); } break;
+			case INV_SIGMOID_: { do_invSigmoid_ROW (topRow ()); } break;
+			default: {
+				/*
+					Functions of one or two numbers that are called through a function pointer,
+					as in do_function_n_n () and do_function_dd_d ().
+				*/
+				double (*f1) (double) = nullptr;
+				double (*f2) (double, double) = nullptr;
+				switch (symbol) {
+					case SINC_: f1 = NUMsinc; break;
+					case SINCPI_: f1 = NUMsincpi; break;
+					case ERF_: f1 = NUMerf; break;
+					case ERFC_: f1 = NUMerfcc; break;
+					case GAUSS_P_: f1 = NUMgaussP; break;
+					case GAUSS_Q_: f1 = NUMgaussQ; break;
+					case INV_GAUSS_Q_: f1 = NUMinvGaussQ; break;
+					case LN_GAMMA_: f1 = NUMlnGamma; break;
+					case HERTZ_TO_BARK_: f1 = NUMhertzToBark; break;
+					case BARK_TO_HERTZ_: f1 = NUMbarkToHertz; break;
+					case PHON_TO_DIFFERENCE_LIMENS_: f1 = NUMphonToDifferenceLimens; break;
+					case DIFFERENCE_LIMENS_TO_PHON_: f1 = NUMdifferenceLimensToPhon; break;
+					case HERTZ_TO_MEL_: f1 = NUMhertzToMel; break;
+					case MEL_TO_HERTZ_: f1 = NUMmelToHertz; break;
+					case HERTZ_TO_SEMITONES_: f1 = NUMhertzToSemitones; break;
+					case SEMITONES_TO_HERTZ_: f1 = NUMsemitonesToHertz; break;
+					case ERB_: f1 = NUMerb; break;
+					case HERTZ_TO_ERB_: f1 = NUMhertzToErb; break;
+					case ERB_TO_HERTZ_: f1 = NUMerbToHertz; break;
+					case ARCTAN2_: f2 = atan2; break;
+					case CHI_SQUARE_P_: f2 = NUMchiSquareP; break;
+					case CHI_SQUARE_Q_: f2 = NUMchiSquareQ; break;
+					case INCOMPLETE_GAMMAP_: f2 = NUMincompleteGammaP; break;
+					case INV_CHI_SQUARE_Q_: f2 = NUMinvChiSquareQ; break;
+					case STUDENT_P_: f2 = NUMstudentP; break;
+					case STUDENT_Q_: f2 = NUMstudentQ; break;
+					case INV_STUDENT_Q_: f2 = NUMinvStudentQ; break;
+					case BETA_: f2 = NUMbeta; break;
+					case BETA2_: f2 = NUMbeta2; break;
+					case LN_BETA_: f2 = NUMlnBeta; break;
+					case SOUND_PRESSURE_TO_PHON_: f2 = NUMsoundPressureToPhon; break;
+					default: Melder_assert (false);
+				}
+				if (f1) {
+					const VEC x = topRow ();
+					for (integer i = 1; i <= n; i ++)
+						x [i] = ( isundef (x [i]) ? undefined : numberForStack (f1 (x [i])) );
+				} else {
+					const VEC y = popRow (), x = topRow ();
+					for (integer i = 1; i <= n; i ++)
+						x [i] = ( isundef (x [i]) || isundef (y [i]) ? undefined : numberForStack (f2 (x [i], y [i])) );
+				}
+			}
+		}
+	}
+	Melder_assert (rowStackPointer == 1);
+	result <<= topRow ();
+}
+
+void FormulaProgram_runRow (FormulaProgram me, const integer row, const integer firstColumn, VEC const& result) {
+	Melder_assert (my isVectorizable);
+	Melder_assert (row >= 1 && firstColumn >= 1);
+	constexpr integer blockSize = 1024;   // small enough for the stack to stay in the cache
+	if (theRowStack.nrow < my maximumRowStackDepth || theRowStack.ncol < blockSize)
+		theRowStack = raw_MAT (std::max (my maximumRowStackDepth, theRowStack.nrow), blockSize);
+	try {
+		for (integer offset = 0; offset < result.size; offset += blockSize) {
+			const integer numberOfColumnsInBlock = std::min (blockSize, result.size - offset);
+			FormulaProgram_runBlock (me, row, firstColumn + offset, result.part (offset + 1, offset + numberOfColumnsInBlock));
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Formula not run.");
+	}
+}
+
 /* End of file Formula.cpp */
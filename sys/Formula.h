@@ -2,7 +2,7 @@
 #define _Formula_h_
 /* Formula.h
  *
- * Copyright (C) 1990-2005,2007,2008,2011-2020,2023 Paul Boersma
+ * Copyright (C) 1990-2005,2007,2008,2011-2020,2023,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -187,9 +187,73 @@ struct Formula_Result {
 
 Thing_declare (Interpreter);
 
+/*
+	The classic interface: compile a formula into a FormulaProgram that is private to the current thread,
+	then run it as often as you like, until the next compilation on the same thread.
+*/
 void Formula_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize);
 
 void Formula_run (integer row, integer col, Formula_Result *result);
 
+/*
+	A FormulaProgram is a compiled formula that is owned by the caller.
+	It is not changed by running it, so it can be run on several threads at the same time
+	(each thread evaluates on its own stack), and it survives any nested compilations,
+	such as those caused by `evaluate`.
+*/
+typedef struct structFormulaInstruction *FormulaInstruction;
+
+Thing_define (FormulaProgram, Thing) {
+	Interpreter interpreter;
+	Daata source;
+	int expressionType;
+	bool optimize;
+	integer numberOfInstructions;
+	FormulaInstruction instructions;   // base-1, terminated by END_; the strings in it belong to the program
+	bool isPointwise;   // see FormulaProgram_isPointwise ()
+	bool isVectorizable;   // see FormulaProgram_runRow ()
+	integer maximumRowStackDepth;
+	bool isReusable;   // see FormulaProgram_isReusable ()
+
+	void v9_destroy () noexcept
+		override;
+};
+
+autoFormulaProgram FormulaProgram_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize);
+
+void FormulaProgram_run (FormulaProgram me, integer row, integer col, Formula_Result *result);
+
+bool FormulaProgram_isPointwise (FormulaProgram me);
+/*
+	True if the value for (row, col) depends only on `row`, `col`, `x`, `y`, `self` (i.e. the cell at (row, col) itself),
+	constants, and numeric variables, through numeric functions without side effects or random numbers.
+	Such a formula gives the same result whatever the order in which the cells are computed,
+	even if each result is written into the object itself, so that the cells can be computed in parallel.
+*/
+
+bool FormulaProgram_isReusable (FormulaProgram me);
+/*
+	True if the formula does not refer to objects by name (as in `Sound_hello [3]` or `Self`),
+	because such references are resolved during compilation, and the objects may be removed or renamed afterwards.
+	A reusable formula can be run again later, as long as its interpreter keeps its variables.
+*/
+
+bool FormulaProgram_isVectorizable (FormulaProgram me);
+/*
+	True if the formula is pointwise and moreover consists only of arithmetic, comparisons,
+	and numeric functions of one or two arguments (no conditionals).
+*/
+
+void FormulaProgram_runRow (FormulaProgram me, integer row, integer firstColumn, VEC const& result);
+/*
+	Preconditions:
+		FormulaProgram_isVectorizable (me);
+		row >= 1;
+		firstColumn >= 1;
+	Postcondition:
+		result [i] is the value of the formula for (row, firstColumn - 1 + i),
+		exactly as FormulaProgram_run () would have computed it.
+*/
+
 /* End of file Formula.h */
 #endif
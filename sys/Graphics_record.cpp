@@ -543,8 +543,8 @@ void Graphics_readRecordings (Graphics me, FILE *f, double heightCorrection) {
 				put (bingetr32 (f) + heightCorrection);   // y1NDC
 				put (bingetr32 (f) + heightCorrection);   // y2NDC
 			} else {
-				for (integer i = numberOfArguments; i > 0; i --)
-					put (bingetr32 (f));
+				bingetr32s (p + 1, numberOfArguments, f);   // e.g. the points of a long polyline, in one go
+				p += numberOfArguments;
 			}
 		}   
 	} catch (MelderError) {
@@ -1240,30 +1240,64 @@ static void Interpreter_addNumericVectorVariable (Interpreter me, conststring32
 	variable.releaseToAmbiguousOwner();
 }
 
-InterpreterVariable Interpreter_hasVariable (Interpreter me, conststring32 key) {
+/*
+	Variables are never removed while a script runs, so a line can hold on to the variable it refers to.
+	Each line remembers the variable it referred to most recently (its "slot"),
+	so that a line that is executed repeatedly finds its variable without building and hashing the full name.
+	The map is consulted only if the name turns out to be different from last time,
+	as with indexed variables, with substitutions such as 'name$', or on a line with several variables.
+*/
+static bool InterpreterVariable_hasName (InterpreterVariable me, conststring32 procedureName, conststring32 key) {
+	const char32 *name = my string.get();
+	if (key [0] == U'.') {
+		const integer procedureNameLength = Melder_length (procedureName);
+		if (! str32nequ (name, procedureName, procedureNameLength))
+			return false;
+		name += procedureNameLength;
+	}
+	return str32equ (name, key);
+}
+
+static InterpreterVariable Interpreter_findVariable (Interpreter me, conststring32 key) {
 	Melder_pre (key);
-	conststring32 variableNameIncludingProcedureName =
-			( key [0] == U'.' ? Melder_cat (my procedureStackNames [my callDepth], key) : key );
+	conststring32 procedureName = my procedureStackNames [my callDepth];
+	const bool lineHasSlot = ( my lineNumber >= 1 && my lineNumber <= my variableSlots.size );
+	if (lineHasSlot) {
+		const InterpreterVariable slot = my variableSlots [my lineNumber];
+		if (slot && InterpreterVariable_hasName (slot, procedureName, key))
+			return slot;
+	}
+	std::u32string& variableNameIncludingProcedureName = my variableNameIncludingProcedureName;
+	variableNameIncludingProcedureName. clear ();
+	if (key [0] == U'.')
+		variableNameIncludingProcedureName. append (procedureName);
+	variableNameIncludingProcedureName. append (key);
 	auto it = my variablesMap. find (variableNameIncludingProcedureName);
-	if (it != my variablesMap.end())
-		return it -> second.get();
-	else
+	if (it == my variablesMap.end())
 		return nullptr;
+	if (lineHasSlot)
+		my variableSlots [my lineNumber] = it -> second.get();
+	return it -> second.get();
+}
+
+InterpreterVariable Interpreter_hasVariable (Interpreter me, conststring32 key) {
+	return Interpreter_findVariable (me, key);
 }
 
 InterpreterVariable Interpreter_lookUpVariable (Interpreter me, conststring32 key) {
-	Melder_pre (key);
-	conststring32 variableNameIncludingProcedureName =
-			( key [0] == U'.' ? Melder_cat (my procedureStackNames [my callDepth], key) : key );
-	auto it = my variablesMap. find (variableNameIncludingProcedureName);
-	if (it != my variablesMap.end())
-		return it -> second.get();
+	InterpreterVariable variable_ref = Interpreter_findVariable (me, key);
+	if (variable_ref)
+		return variable_ref;
 	/*
 		The variable doesn't yet exist: create a new one.
+		Its full name is still in the scratch string.
 	*/
-	autoInterpreterVariable variable = InterpreterVariable_create (variableNameIncludingProcedureName);
-	InterpreterVariable variable_ref = variable.get();
+	const std::u32string variableNameIncludingProcedureName = my variableNameIncludingProcedureName;
+	autoInterpreterVariable variable = InterpreterVariable_create (variableNameIncludingProcedureName.c_str());
+	variable_ref = variable.get();
 	my variablesMap [variableNameIncludingProcedureName] = variable.move();
+	if (my lineNumber >= 1 && my lineNumber <= my variableSlots.size)
+		my variableSlots [my lineNumber] = variable_ref;
 	return variable_ref;
 }
 
@@ -1503,6 +1537,33 @@ inline static void NumericMatrixVariable_divide (InterpreterVariable variable, c
 			variableMatrix [irow] [icol] /= matrix [irow] [icol];
 }
 
+/*
+	The line at which to start looking for the definition of a procedure that is called with `@`.
+	The first time, we index the procedure definitions, in the same way as Interpreter_do_procedureCall () reads them;
+	the index stops at a definition without a name, and for procedures that are not in the index
+	we return line 1, so that the search by Interpreter_do_procedureCall () generates the usual error messages.
+*/
+static integer Interpreter_findProcedureDefinition (Interpreter me, conststring32 procedureName) {
+	if (! my procedureDefinitionsHaveBeenIndexed) {
+		for (integer iline = 1; iline <= my lines.size; iline ++) {
+			const char32 *q = my lines [iline];
+			if (! str32nequ (q, U"procedure", 9) || ! Melder_isHorizontalSpace (q [9]))
+				continue;
+			q += 10;
+			Melder_skipHorizontalSpace (& q);
+			const char32 *const name = q;
+			while (Melder_staysWithinInk (*q) && *q != U'(' && *q != U':')
+				q ++;
+			if (q == name)
+				break;
+			my procedureDefinitionLines. emplace (std::u32string (name, size_t (q - name)), iline);   // the first one counts
+		}
+		my procedureDefinitionsHaveBeenIndexed = true;
+	}
+	const auto it = my procedureDefinitionLines. find (procedureName);
+	return it == my procedureDefinitionLines. end () ? 1 : it -> second;
+}
+
 static void Interpreter_do_procedureCall (Interpreter me, char32 *command,
 	constvector <mutablestring32> const& lines, integer& lineNumber, integer callStack [], int& callDepth)
 {
@@ -1532,7 +1593,7 @@ static void Interpreter_do_procedureCall (Interpreter me, char32 *command,
 		p ++;   // step over parenthesis or colon
 	}
 	const integer callLength = Melder_length (callName);
-	integer iline = 1;
+	integer iline = Interpreter_findProcedureDefinition (me, callName);
 	for (; iline <= lines.size; iline ++) {
 		if (! str32nequ (lines [iline], U"procedure", 9) || ! Melder_isHorizontalSpace (lines [iline] [9]))
 			continue;
@@ -2145,6 +2206,12 @@ static void private_Interpreter_initialize (Interpreter me, autostring32 text, c
 		Remember line starts, labels and procedures.
 	*/
 	my lines. resize (numberOfLines);
+	my jumpTargetsIfFalse = zero_INTVEC (numberOfLines);
+	my jumpTargetsAlways = zero_INTVEC (numberOfLines);
+	my compiledExpressions. clear ();
+	my procedureDefinitionLines. clear ();
+	my procedureDefinitionsHaveBeenIndexed = false;
+	my variableSlots = newvectorzero <InterpreterVariable> (numberOfLines);
 	command = my text.get();   // reset
 	my labelNames. reset();
 	my labelLines. reset();
@@ -2326,6 +2393,19 @@ static void private_Interpreter_initialize (Interpreter me, autostring32 text, c
 	}
 }
 
+/*
+	Continue with line `target` (as found in jumpTargetsIfFalse or jumpTargetsAlways),
+	or, if `target` is negative, with the `elsif` or `elif` on line `- target`.
+*/
+static void Interpreter_jumpTo (Interpreter me, const integer target) {
+	Melder_assert (target != 0);
+	if (target < 0) {
+		my lineNumber = - target - 1;   // the loop will add 1
+		my fromif = true;
+	} else
+		my lineNumber = target - 1;   // the loop will add 1
+}
+
 void Interpreter_run (Interpreter me, autostring32 text, const bool reuseVariables) {
 	try {
 		//TRACE
@@ -2495,42 +2575,53 @@ void Interpreter_resume (Interpreter me) {
 								const char32 *startOfInk = Melder_findInk (command2.string + 6);
 								if (startOfInk && *startOfInk != U';')
 									Melder_throw (U"Stray text after 'endfor'.");
-								int depth = 0;
-								integer iline;
-								for (iline = my lineNumber - 1; iline > 0; iline --) {
-									char32 *line = lines [iline];
-									if (line [0] == U'f' && line [1] == U'o' && line [2] == U'r' && line [3] == U' ') {
-										if (depth == 0) { my lineNumber = iline - 1; my fromendfor = true; break; }   // go before 'for'
-										else depth --;
-									} else if (str32nequ (lines [iline], U"endfor", 6) &&
-											(! Melder_staysWithinInk (lines [iline] [6]) || lines [iline] [6] == U';'))
-									{
-										depth ++;
+								integer target = my jumpTargetsAlways [my lineNumber];
+								if (target == 0) {
+									int depth = 0;
+									integer iline;
+									for (iline = my lineNumber - 1; iline > 0; iline --) {
+										char32 *line = lines [iline];
+										if (line [0] == U'f' && line [1] == U'o' && line [2] == U'r' && line [3] == U' ') {
+											if (depth == 0) { target = iline; break; }   // go to 'for'
+											else depth --;
+										} else if (str32nequ (lines [iline], U"endfor", 6) &&
+												(! Melder_staysWithinInk (lines [iline] [6]) || lines [iline] [6] == U';'))
+										{
+											depth ++;
+										}
 									}
+									if (iline <= 0) Melder_throw (U"Unmatched 'endfor'.");
+									my jumpTargetsAlways [my lineNumber] = target;
 								}
-								if (iline <= 0) Melder_throw (U"Unmatched 'endfor'.");
+								Interpreter_jumpTo (me, target);
+								my fromendfor = true;
 							} else if (str32nequ (command2.string, U"endwhile", 8) &&
 									(! Melder_staysWithinInk (command2.string [8]) || command2.string [8] == U';'))
 							{
 								const char32 *startOfInk = Melder_findInk (command2.string + 8);
 								if (startOfInk && *startOfInk != U';')
 									Melder_throw (U"Stray text after 'endwhile'.");
-								int depth = 0;
-								integer iline;
-								for (iline = my lineNumber - 1; iline > 0; iline --) {
-									if (str32nequ (lines [iline], U"while ", 6)) {
-										if (depth == 0) {
-											my lineNumber = iline - 1;
-											break;   // go before 'while'
-										} else
-											depth --;
-									} else if (str32nequ (lines [iline], U"endwhile", 8) &&
-											(! Melder_staysWithinInk (lines [iline] [8]) || lines [iline] [8] == U';'))
-									{
-										depth ++;
+								integer target = my jumpTargetsAlways [my lineNumber];
+								if (target == 0) {
+									int depth = 0;
+									integer iline;
+									for (iline = my lineNumber - 1; iline > 0; iline --) {
+										if (str32nequ (lines [iline], U"while ", 6)) {
+											if (depth == 0) {
+												target = iline;
+												break;   // go to 'while'
+											} else
+												depth --;
+										} else if (str32nequ (lines [iline], U"endwhile", 8) &&
+												(! Melder_staysWithinInk (lines [iline] [8]) || lines [iline] [8] == U';'))
+										{
+											depth ++;
+										}
 									}
+									if (iline <= 0) Melder_throw (U"Unmatched 'endwhile'.");
+									my jumpTargetsAlways [my lineNumber] = target;
 								}
-								if (iline <= 0) Melder_throw (U"Unmatched 'endwhile'.");
+								Interpreter_jumpTo (me, target);
 							} else if (str32nequ (command2.string, U"endproc", 7) &&
 									(! Melder_staysWithinInk (command2.string [7]) || command2.string [7] == U';'))
 							{
@@ -2548,31 +2639,85 @@ void Interpreter_resume (Interpreter me) {
 							const char32 *startOfInk = Melder_findInk (command2.string + 4);
 							if (startOfInk && *startOfInk != U';')
 								Melder_throw (U"Stray text after 'else'.");
-							int depth = 0;
-							integer iline;
-							for (iline = my lineNumber + 1; iline <= numberOfLines; iline ++) {
-								if (str32nequ (lines [iline], U"endif", 5) &&
-										(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
-								{
-									startOfInk = Melder_findInk (lines [iline] + 5);
-									if (startOfInk && *startOfInk != U';') {
-										my lineNumber = iline;   // on behalf of the error message
-										Melder_throw (U"Stray text after 'endif'.");
+							integer target = my jumpTargetsAlways [my lineNumber];
+							if (target == 0) {
+								int depth = 0;
+								integer iline;
+								for (iline = my lineNumber + 1; iline <= numberOfLines; iline ++) {
+									if (str32nequ (lines [iline], U"endif", 5) &&
+											(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
+									{
+										startOfInk = Melder_findInk (lines [iline] + 5);
+										if (startOfInk && *startOfInk != U';') {
+											my lineNumber = iline;   // on behalf of the error message
+											Melder_throw (U"Stray text after 'endif'.");
+										}
+										if (depth == 0) { target = iline + 1; break; }   // go after `endif`
+										else depth --;
+									} else if (str32nequ (lines [iline], U"if ", 3)) {
+										depth ++;
 									}
-									if (depth == 0) { my lineNumber = iline; break; }   // go after `endif`
-									else depth --;
-								} else if (str32nequ (lines [iline], U"if ", 3)) {
-									depth ++;
 								}
+								if (iline > numberOfLines)
+									Melder_throw (U"Unmatched 'else'.");
+								my jumpTargetsAlways [my lineNumber] = target;
 							}
-							if (iline > numberOfLines)
-								Melder_throw (U"Unmatched 'else'.");
+							Interpreter_jumpTo (me, target);
 						} else if (str32nequ (command2.string, U"elsif ", 6) || str32nequ (command2.string, U"elif ", 5)) {
 							if (my fromif) {
 								double value;
 								my fromif = false;
 								Interpreter_numericExpression (me, command2.string + 5, & value);
 								if (value == 0.0) {
+									integer target = my jumpTargetsIfFalse [my lineNumber];
+									if (target == 0) {
+										int depth = 0;
+										integer iline;
+										for (iline = my lineNumber + 1; iline <= numberOfLines; iline ++) {
+											if (str32nequ (lines [iline], U"endif", 5) &&
+													(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
+											{
+												const char32 *startOfInk = Melder_findInk (lines [iline] + 5);
+												if (startOfInk && *startOfInk != U';') {
+													my lineNumber = iline;   // on behalf of error message
+													Melder_throw (U"Stray text after 'endif'.");
+												}
+												if (depth == 0) {
+													target = iline + 1;
+													break;   // go after `endif`
+												} else
+													depth --;
+											} else if (str32nequ (lines [iline], U"else", 4) &&
+													(! Melder_staysWithinInk (lines [iline] [4]) || lines [iline] [4] == U';'))
+											{
+												const char32 *startOfInk = Melder_findInk (lines [iline] + 4);
+												if (startOfInk && *startOfInk != U';') {
+													my lineNumber = iline;   // on behalf of error message
+													Melder_throw (U"Stray text after 'else'.");
+												}
+												if (depth == 0) {
+													target = iline + 1;
+													break;   // go after `else`
+												}
+											} else if ((str32nequ (lines [iline], U"elsif", 5) && ! Melder_staysWithinInk (lines [iline] [5]))
+												|| (str32nequ (lines [iline], U"elif", 4) && ! Melder_staysWithinInk (lines [iline] [4]))) {
+												if (depth == 0) {
+													target = - iline;
+													break;   // go at next 'elsif' or 'elif'
+												}
+											} else if (str32nequ (lines [iline], U"if ", 3)) {
+												depth ++;
+											}
+										}
+										if (iline > numberOfLines)
+											Melder_throw (U"Unmatched 'elsif'.");
+										my jumpTargetsIfFalse [my lineNumber] = target;
+									}
+									Interpreter_jumpTo (me, target);
+								}
+							} else {
+								integer target = my jumpTargetsAlways [my lineNumber];
+								if (target == 0) {
 									int depth = 0;
 									integer iline;
 									for (iline = my lineNumber + 1; iline <= numberOfLines; iline ++) {
@@ -2585,59 +2730,19 @@ void Interpreter_resume (Interpreter me) {
 												Melder_throw (U"Stray text after 'endif'.");
 											}
 											if (depth == 0) {
-												my lineNumber = iline;
+												target = iline + 1;
 												break;   // go after `endif`
 											} else
 												depth --;
-										} else if (str32nequ (lines [iline], U"else", 4) &&
-												(! Melder_staysWithinInk (lines [iline] [4]) || lines [iline] [4] == U';'))
-										{
-											const char32 *startOfInk = Melder_findInk (lines [iline] + 4);
-											if (startOfInk && *startOfInk != U';') {
-												my lineNumber = iline;   // on behalf of error message
-												Melder_throw (U"Stray text after 'else'.");
-											}
-											if (depth == 0) {
-												my lineNumber = iline;
-												break;   // go after `else`
-											}
-										} else if ((str32nequ (lines [iline], U"elsif", 5) && ! Melder_staysWithinInk (lines [iline] [5]))
-											|| (str32nequ (lines [iline], U"elif", 4) && ! Melder_staysWithinInk (lines [iline] [4]))) {
-											if (depth == 0) {
-												my lineNumber = iline - 1;
-												my fromif = true;
-												break;   // go at next 'elsif' or 'elif'
-											}
 										} else if (str32nequ (lines [iline], U"if ", 3)) {
 											depth ++;
 										}
 									}
 									if (iline > numberOfLines)
-										Melder_throw (U"Unmatched 'elsif'.");
+										Melder_throw (U"'elsif' not matched with 'endif'.");
+									my jumpTargetsAlways [my lineNumber] = target;
 								}
-							} else {
-								int depth = 0;
-								integer iline;
-								for (iline = my lineNumber + 1; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endif", 5) &&
-											(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
-									{
-										const char32 *startOfInk = Melder_findInk (lines [iline] + 5);
-										if (startOfInk && *startOfInk != U';') {
-											my lineNumber = iline;   // on behalf of error message
-											Melder_throw (U"Stray text after 'endif'.");
-										}
-										if (depth == 0) {
-											my lineNumber = iline;
-											break;   // go after `endif`
-										} else
-											depth --;
-									} else if (str32nequ (lines [iline], U"if ", 3)) {
-										depth ++;
-									}
-								}
-								if (iline > numberOfLines)
-									Melder_throw (U"'elsif' not matched with 'endif'.");
+								Interpreter_jumpTo (me, target);
 							}
 						} else if (str32nequ (command2.string, U"exit", 4)) {
 							if (command2.string [4] == U'\0') {
@@ -2684,28 +2789,33 @@ void Interpreter_resume (Interpreter me) {
 							}
 							var -> numericValue = loopVariable;
 							if (loopVariable > toValue) {
-								int depth = 0;
-								integer iline;
-								for (iline = my lineNumber + 1; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endfor", 6) &&
-											(! Melder_staysWithinInk (lines [iline] [6]) || lines [iline] [6] == U';'))
-									{
-										const char32 *startOfInk = Melder_findInk (lines [iline] + 6);
-										if (startOfInk && *startOfInk != U';') {
-											my lineNumber = iline;   // on behalf of error message
-											Melder_throw (U"Stray text after 'endfor'.");
+								integer target = my jumpTargetsIfFalse [my lineNumber];
+								if (target == 0) {
+									int depth = 0;
+									integer iline;
+									for (iline = my lineNumber + 1; iline <= numberOfLines; iline ++) {
+										if (str32nequ (lines [iline], U"endfor", 6) &&
+												(! Melder_staysWithinInk (lines [iline] [6]) || lines [iline] [6] == U';'))
+										{
+											const char32 *startOfInk = Melder_findInk (lines [iline] + 6);
+											if (startOfInk && *startOfInk != U';') {
+												my lineNumber = iline;   // on behalf of error message
+												Melder_throw (U"Stray text after 'endfor'.");
+											}
+											if (depth == 0) {
+												target = iline + 1;
+												break;   // go after 'endfor'
+											} else
+												depth --;
+										} else if (str32nequ (lines [iline], U"for ", 4)) {
+											depth ++;
 										}
-										if (depth == 0) {
-											my lineNumber = iline;
-											break;   // go after 'endfor'
-										} else
-											depth --;
-									} else if (str32nequ (lines [iline], U"for ", 4)) {
-										depth ++;
 									}
+									if (iline > numberOfLines)
+										Melder_throw (U"Unmatched 'for' (matching 'endfor' not found).");
+									my jumpTargetsIfFalse [my lineNumber] = target;
 								}
-								if (iline > numberOfLines)
-									Melder_throw (U"Unmatched 'for' (matching 'endfor' not found).");
+								Interpreter_jumpTo (me, target);
 							}
 						} else if (str32nequ (command2.string, U"form", 4) &&
 								(command2.string [4] == U':' || Melder_isEndOfInk (command2.string [4])))
@@ -2765,46 +2875,50 @@ void Interpreter_resume (Interpreter me) {
 							double value;
 							Interpreter_numericExpression (me, command2.string + 3, & value);
 							if (value == 0.0) {
-								int depth = 0;
-								integer iline;
-								for (iline = my lineNumber + 1; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endif", 5) &&
-											(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
-									{
-										const char32 *startOfInk = Melder_findInk (lines [iline] + 5);
-										if (startOfInk && *startOfInk != U';') {
-											my lineNumber = iline;   // on behalf of error message
-											Melder_throw (U"Stray text after 'endif'.");
-										}
-										if (depth == 0) {
-											my lineNumber = iline;
-											break;   // go after 'endif'
-										} else
-											depth --;
-									} else if (str32nequ (lines [iline], U"else", 4) &&
-											(! Melder_staysWithinInk (lines [iline] [4]) || lines [iline] [4] == U';'))
-									{
-										const char32 *startOfInk = Melder_findInk (lines [iline] + 4);
-										if (startOfInk && *startOfInk != U';') {
-											my lineNumber = iline;   // on behalf of error message
-											Melder_throw (U"Stray text after 'else'.");
-										}
-										if (depth == 0) {
-											my lineNumber = iline;
-											break;   // go after 'else'
-										}
-									} else if (str32nequ (lines [iline], U"elsif ", 6) || str32nequ (lines [iline], U"elif ", 5)) {
-										if (depth == 0) {
-											my lineNumber = iline - 1;
-											my fromif = true;
-											break;   // go at 'elsif'
+								integer target = my jumpTargetsIfFalse [my lineNumber];
+								if (target == 0) {
+									int depth = 0;
+									integer iline;
+									for (iline = my lineNumber + 1; iline <= numberOfLines; iline ++) {
+										if (str32nequ (lines [iline], U"endif", 5) &&
+												(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
+										{
+											const char32 *startOfInk = Melder_findInk (lines [iline] + 5);
+											if (startOfInk && *startOfInk != U';') {
+												my lineNumber = iline;   // on behalf of error message
+												Melder_throw (U"Stray text after 'endif'.");
+											}
+											if (depth == 0) {
+												target = iline + 1;
+												break;   // go after 'endif'
+											} else
+												depth --;
+										} else if (str32nequ (lines [iline], U"else", 4) &&
+												(! Melder_staysWithinInk (lines [iline] [4]) || lines [iline] [4] == U';'))
+										{
+											const char32 *startOfInk = Melder_findInk (lines [iline] + 4);
+											if (startOfInk && *startOfInk != U';') {
+												my lineNumber = iline;   // on behalf of error message
+												Melder_throw (U"Stray text after 'else'.");
+											}
+											if (depth == 0) {
+												target = iline + 1;
+												break;   // go after 'else'
+											}
+										} else if (str32nequ (lines [iline], U"elsif ", 6) || str32nequ (lines [iline], U"elif ", 5)) {
+											if (depth == 0) {
+												target = - iline;
+												break;   // go at 'elsif'
+											}
+										} else if (str32nequ (lines [iline], U"if ", 3)) {
+											depth ++;
 										}
-									} else if (str32nequ (lines [iline], U"if ", 3)) {
-										depth ++;
 									}
+									if (iline > numberOfLines)
+										Melder_throw (U"Unmatched 'if'.");
+									my jumpTargetsIfFalse [my lineNumber] = target;
 								}
-								if (iline > numberOfLines)
-									Melder_throw (U"Unmatched 'if'.");
+								Interpreter_jumpTo (me, target);
 							} else if (isundef (value)) {
 								Melder_throw (U"The value of the 'if' condition is undefined.");
 							}
@@ -2922,28 +3036,33 @@ void Interpreter_resume (Interpreter me) {
 							double value;
 							Interpreter_numericExpression (me, command2.string + 6, & value);
 							if (value == 0.0) {
-								int depth = 0;
-								integer iline = my lineNumber + 1;
-								for (; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endwhile", 8) &&
-											(! Melder_staysWithinInk (lines [iline] [8]) || lines [iline] [8] == U';'))
-									{
-										const char32 *startOfInk = Melder_findInk (lines [iline] + 8);
-										if (startOfInk && *startOfInk != U';') {
-											my lineNumber = iline;
-											Melder_throw (U"Stray text after 'endwhile'.");
+								integer target = my jumpTargetsIfFalse [my lineNumber];
+								if (target == 0) {
+									int depth = 0;
+									integer iline = my lineNumber + 1;
+									for (; iline <= numberOfLines; iline ++) {
+										if (str32nequ (lines [iline], U"endwhile", 8) &&
+												(! Melder_staysWithinInk (lines [iline] [8]) || lines [iline] [8] == U';'))
+										{
+											const char32 *startOfInk = Melder_findInk (lines [iline] + 8);
+											if (startOfInk && *startOfInk != U';') {
+												my lineNumber = iline;
+												Melder_throw (U"Stray text after 'endwhile'.");
+											}
+											if (depth == 0) {
+												target = iline + 1;
+												break;   // go after `endwhile`
+											} else
+												depth --;
+										} else if (str32nequ (lines [iline], U"while ", 6)) {
+											depth ++;
 										}
-										if (depth == 0) {
-											my lineNumber = iline;
-											break;   // go after `endwhile`
-										} else
-											depth --;
-									} else if (str32nequ (lines [iline], U"while ", 6)) {
-										depth ++;
 									}
+									if (iline > numberOfLines)
+										Melder_throw (U"Unmatched 'while'.");
+									my jumpTargetsIfFalse [my lineNumber] = target;
 								}
-								if (iline > numberOfLines)
-									Melder_throw (U"Unmatched 'while'.");
+								Interpreter_jumpTo (me, target);
 							}
 						} else
 							fail = true;
@@ -3669,56 +3788,92 @@ void Interpreter_stop (Interpreter me) {
 //Melder_casual (U"Interpreter_stop out: ", Melder_pointer (me));
 }
 
+/*
+	Compiling an expression takes much more time than running it,
+	so we compile each expression only once per run of the script,
+	even if the line that contains it is executed a million times.
+*/
+static void Interpreter_runExpression (Interpreter me, conststring32 expression, const int expressionType, Formula_Result *out_result) {
+	/*
+		The same text can mean different things for different expression types,
+		and in different procedures (because of local variables).
+	*/
+	std::u32string& key = my compiledExpressionKey;
+	key. clear ();
+	key. push_back (char32 (U'0' + expressionType));
+	key. append (my procedureStackNames [my callDepth]);
+	key. push_back (U'\n');   // cannot occur in a procedure name
+	key. append (expression);
+	auto compiledExpression = my compiledExpressions. extract (key);
+	if (compiledExpression. empty ()) {
+		autoFormulaProgram program = FormulaProgram_compile (me, nullptr, expression, expressionType, false);
+		if (! FormulaProgram_isReusable (program.get())) {
+			FormulaProgram_run (program.get(), 0, 0, out_result);
+			return;
+		}
+		/*
+			Lines with substituted variables (e.g. 'i') can produce a different expression each time,
+			so we don't let the collection grow without bounds.
+		*/
+		constexpr size_t maximumNumberOfCompiledExpressions = 1000;
+		if (my compiledExpressions. size () >= maximumNumberOfCompiledExpressions)
+			my compiledExpressions. clear ();
+		auto [position, inserted] = my compiledExpressions. emplace (key, program.move());
+		Melder_assert (inserted);
+		compiledExpression = my compiledExpressions. extract (position);
+	}
+	/*
+		While it runs, the program is not in the collection,
+		so that it survives if a nested expression (e.g. via `evaluate`) clears the collection.
+		If the run fails, the program is simply compiled again next time.
+	*/
+	FormulaProgram_run (compiledExpression. mapped (). get(), 0, 0, out_result);
+	my compiledExpressions. insert (std::move (compiledExpression));
+}
+
 void Interpreter_voidExpression (Interpreter me, conststring32 expression) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC, false);
 	Formula_Result result;
-	Formula_run (0, 0, & result);
+	Interpreter_runExpression (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, & result);
 }
 
 void Interpreter_numericExpression (Interpreter me, conststring32 expression, double *out_value) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC, false);
 	Formula_Result result;
-	Formula_run (0, 0, & result);
+	Interpreter_runExpression (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, & result);
 	*out_value = result. numericResult;
 }
 
 void Interpreter_numericVectorExpression (Interpreter me, conststring32 expression, VEC *out_value, bool *out_owned) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR, false);
 	Formula_Result result;
-	Formula_run (0, 0, & result);
+	Interpreter_runExpression (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR, & result);
 	*out_value = result. numericVectorResult;
 	*out_owned = result. owned;
 	result. owned = false;
 }
 
 void Interpreter_numericMatrixExpression (Interpreter me, conststring32 expression, MAT *out_value, bool *out_owned) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX, false);
 	Formula_Result result;
-	Formula_run (0, 0, & result);
+	Interpreter_runExpression (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX, & result);
 	*out_value = result. numericMatrixResult;
 	*out_owned = result. owned;
 	result. owned = false;
 }
 
 autostring32 Interpreter_stringExpression (Interpreter me, conststring32 expression) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_STRING, false);
 	Formula_Result result;
-	Formula_run (0, 0, & result);
+	Interpreter_runExpression (me, expression, kFormula_EXPRESSION_TYPE_STRING, & result);
 	return result. stringResult.move();
 }
 
 void Interpreter_stringArrayExpression (Interpreter me, conststring32 expression, STRVEC *out_value, bool *out_owned) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_STRING_ARRAY, false);
 	Formula_Result result;
-	Formula_run (0, 0, & result);
+	Interpreter_runExpression (me, expression, kFormula_EXPRESSION_TYPE_STRING_ARRAY, & result);
 	*out_value = result. stringArrayResult;
 	*out_owned = result. owned;
 	result. owned = false;
 }
 
 void Interpreter_anyExpression (Interpreter me, conststring32 expression, Formula_Result *out_result) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_UNKNOWN, false);
-	Formula_run (0, 0, out_result);
+	Interpreter_runExpression (me, expression, kFormula_EXPRESSION_TYPE_UNKNOWN, out_result);
 }
 
 Thing_implement (InterpreterStack, Thing, 0);
@@ -178,6 +178,20 @@ Thing_define (Interpreter, Thing) {
 	bool fromif, fromendfor;
 
 	autovector <mutablestring32> lines;   // not autostringvector, because the elements are reference copies
+	/*
+		What the interpreter finds out about the script while running it,
+		so that lines that are executed repeatedly (e.g. in a loop) don't have to be analysed again.
+		Jump targets are the numbers of the lines to execute next (0 = not yet known),
+		with negative numbers for an `elsif` that is to be tested (see Interpreter_jumpTo).
+	*/
+	autoINTVEC jumpTargetsIfFalse;   // after a false condition in `if`, `elsif`, `for` or `while`
+	autoINTVEC jumpTargetsAlways;   // after `else`, `endfor`, `endwhile`, or `elsif` after a true branch
+	std::unordered_map <std::u32string, autoFormulaProgram> compiledExpressions;
+	std::u32string compiledExpressionKey;   // scratch
+	std::unordered_map <std::u32string, integer> procedureDefinitionLines;
+	bool procedureDefinitionsHaveBeenIndexed;
+	autovector <InterpreterVariable> variableSlots;   // for each line, the variable it referred to most recently
+	std::u32string variableNameIncludingProcedureName;   // scratch
 	integer lineNumber = 0;
 	integer assertErrorLineNumber = 0;
 	autoMelderString assertErrorString;
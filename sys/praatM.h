@@ -1287,6 +1287,14 @@
 #define SAVE_ONE_BY_NAME_END  \
 	END_NO_NEW_DATA
 
+#define SAVE_ONE_AND_ONE_BY_NAME(klas1,klas2,fileName,trustMessage)  \
+	FIND_ONE_AND_ONE (klas1, klas2) \
+	structMelderFile file { }; \
+	Melder_relativePathToFile (fileName, & file); \
+	Melder_checkTrust (interpreter, fileName, trustMessage U"\n", & file);
+#define SAVE_ONE_AND_ONE_BY_NAME_END  \
+	END_NO_NEW_DATA
+
 #define SAVE_TWO(klas,trustMessage)  \
 	FIND_TWO (klas) \
 	Melder_checkTrust (_interpreter_, trustMessage U"\n", file);
@@ -1,6 +1,6 @@
 /* praat_actions.cpp
  *
- * Copyright (C) 1992-2018,2020-2024 Paul Boersma
+ * Copyright (C) 1992-2018,2020-2024,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -21,12 +21,60 @@
 #include "../kar/longchar.h"
 #include "machine.h"
 #include "GuiP.h"
+#include <unordered_map>
 
 #define BUTTON_LEFT  -240
 #define BUTTON_RIGHT -5
 
 static OrderedOf <structPraat_Command> theActions;
 void praat_actions_exit_optimizeByLeaking () { theActions. _ownItems = false; }
+
+/*
+	Scripts and the registration of commands look up actions by title,
+	so we keep an index from each title to all the actions with that title
+	(usually only one, or one per class).
+	The index has to be updated whenever an action is added to or removed from `theActions`;
+	hiding, showing and sorting actions do not change it.
+*/
+static std::unordered_multimap <std::u32string, Praat_Command> theActionsByTitle;
+
+static void indexAction (Praat_Command action) {
+	if (action -> title)
+		theActionsByTitle. emplace (action -> title.get(), action);
+}
+static void unindexAction (Praat_Command action) {
+	if (! action -> title)
+		return;
+	const auto range = theActionsByTitle. equal_range (action -> title.get());
+	for (auto it = range.first; it != range.second; ++ it) {
+		if (it -> second == action) {
+			theActionsByTitle. erase (it);
+			return;
+		}
+	}
+}
+static integer positionOfAction (Praat_Command action) {
+	/*
+		Commands are mostly put after commands that were added shortly before,
+		so we search from the end.
+	*/
+	for (integer i = theActions.size; i > 0; i --)
+		if (theActions.at [i] == action)
+			return i;
+	Melder_assert (false);
+	return 0;
+}
+static bool actionComesBefore (Praat_Command me, Praat_Command thee) {
+	/*
+		Only needed if several actions with the same title compete,
+		in which case the first one in the list wins, as it would in a linear search.
+	*/
+	return positionOfAction (me) < positionOfAction (thee);
+}
+static void removeAction (integer position) {
+	unindexAction (theActions.at [position]);
+	theActions. removeItem (position);
+}
 static GuiMenu praat_writeMenu;
 static GuiMenuItem praat_writeMenuSeparator;
 static GuiForm praat_form;
@@ -84,21 +132,25 @@ static void fixSelectionSpecification (ClassInfo *class1, integer *n1, ClassInfo
 	}
 }
 
-static integer lookUpMatchingAction (ClassInfo class1, ClassInfo class2, ClassInfo class3, ClassInfo class4, conststring32 title) {
+static Praat_Command lookUpMatchingAction (ClassInfo class1, ClassInfo class2, ClassInfo class3, ClassInfo class4, conststring32 title) {
 /*
 	An action command is fully specified by its environment (the selected classes) and its title.
 	Precondition:
 		class1, class2, and class3 must be in sorted order.
 */
-	for (integer i = 1; i <= theActions.size; i ++) {
-		Praat_Command action = theActions.at [i];
+	if (! title)
+		return nullptr;
+	Praat_Command actionFound = nullptr;
+	const auto range = theActionsByTitle. equal_range (title);
+	for (auto it = range.first; it != range.second; ++ it) {
+		Praat_Command action = it -> second;
 		if (class1 == action -> class1 && class2 == action -> class2 &&
 			class3 == action -> class3 && class4 == action -> class4 &&
-			title && action -> title && str32equ (action -> title.get(), title)
+			(! actionFound || actionComesBefore (action, actionFound))
 		)
-			return i;
+			actionFound = action;
 	}
-	return 0;   // not found
+	return actionFound;   // null if not found
 }
 
 void praat_addAction1_ (ClassInfo class1, integer n1,
@@ -146,11 +198,11 @@ static void praat_addAction4__ (ClassInfo class1, integer n1, ClassInfo class2,
 		*/
 		integer position;
 		if (after) {   // search for existing command with same selection
-			const integer found = lookUpMatchingAction (class1, class2, class3, class4, after);
-			if (found == 0)
+			const Praat_Command found = lookUpMatchingAction (class1, class2, class3, class4, after);
+			if (! found)
 				Melder_throw (U"The action command \"", title, U"\" cannot be put after \"", after, U"\",\n"
 					U"because the latter command does not exist.");
-			position = found + 1;   // after 'after'
+			position = positionOfAction (found) + 1;   // after 'after'
 		} else {
 			position = theActions.size + 1;   // at end
 		}
@@ -180,6 +232,7 @@ static void praat_addAction4__ (ClassInfo class1, integer n1, ClassInfo class2,
 		/*
 			Insert new command.
 		*/
+		indexAction (action.get());
 		theActions. addItemAtPosition_move (action.move(), position);
 	} catch (MelderError) {
 		Melder_flushError ();
@@ -345,9 +398,9 @@ void praat_addActionScript (conststring32 className1, integer n1, conststring32
 			If the button already exists, remove it.
 		*/
 		{// scope
-			integer found = lookUpMatchingAction (class1, class2, class3, nullptr, title);
+			const Praat_Command found = lookUpMatchingAction (class1, class2, class3, nullptr, title);
 			if (found)
-				theActions. removeItem (found);
+				removeAction (positionOfAction (found));
 		}
 
 		/*
@@ -355,9 +408,9 @@ void praat_addActionScript (conststring32 className1, integer n1, conststring32
 		*/
 		integer position;
 		if (after [0] != U'\0') {   // search for existing command with same selection
-			integer found = lookUpMatchingAction (class1, class2, class3, nullptr, after);
+			const Praat_Command found = lookUpMatchingAction (class1, class2, class3, nullptr, after);
 			if (found)
-				position = found + 1;   // after 'after'
+				position = positionOfAction (found) + 1;   // after 'after'
 			else
 				position = theActions.size + 1;   // at end
 		} else {
@@ -396,6 +449,7 @@ void praat_addActionScript (conststring32 className1, integer n1, conststring32
 		/*
 			Insert new command.
 		*/
+		indexAction (action.get());
 		theActions. addItemAtPosition_move (action.move(), position);
 		updateDynamicMenu ();
 	} catch (MelderError) {
@@ -407,7 +461,7 @@ void praat_removeAction (ClassInfo class1, ClassInfo class2, ClassInfo class3, c
 	try {
 		integer n1, n2, n3;
 		fixSelectionSpecification (& class1, & n1, & class2, & n2, & class3, & n3);
-		integer found = lookUpMatchingAction (class1, class2, class3, nullptr, title);
+		const Praat_Command found = lookUpMatchingAction (class1, class2, class3, nullptr, title);
 		if (! found) {
 			Melder_throw (U"Action command \"", class1 -> className,
 				class2 ? U" & ": U"", class2 -> className,
@@ -415,7 +469,7 @@ void praat_removeAction (ClassInfo class1, ClassInfo class2, ClassInfo class3, c
 				U": ", title, U"\" not found."
 			);
 		}
-		theActions. removeItem (found);
+		removeAction (positionOfAction (found));
 	} catch (MelderError) {
 		Melder_throw (U"Praat: action not removed.");
 	}
@@ -444,15 +498,14 @@ void praat_hideAction (ClassInfo class1, ClassInfo class2, ClassInfo class3, con
 	try {
 		integer n1, n2, n3;
 		fixSelectionSpecification (& class1, & n1, & class2, & n2, & class3, & n3);
-		integer found = lookUpMatchingAction (class1, class2, class3, nullptr, title);
-		if (! found) {
+		const Praat_Command action = lookUpMatchingAction (class1, class2, class3, nullptr, title);
+		if (! action) {
 			Melder_throw (U"Praat: action command \"", class1 ? class1 -> className : nullptr,
 				class2 ? U" & ": nullptr, class2 ? class2 -> className : nullptr,
 				class3 ? U" & ": nullptr, class3 ? class3 -> className : nullptr,
 				U": ", title, U"\" not found."
 			);
 		}
-		Praat_Command action = theActions.at [found];
 		if (! action -> hidden) {
 			action -> hidden = true;
 			if (praatP.phase >= praat_READING_BUTTONS)
@@ -486,15 +539,14 @@ void praat_showAction (ClassInfo class1, ClassInfo class2, ClassInfo class3, con
 	try {
 		integer n1, n2, n3;
 		fixSelectionSpecification (& class1, & n1, & class2, & n2, & class3, & n3);
-		integer found = lookUpMatchingAction (class1, class2, class3, nullptr, title);
-		if (! found) {
+		const Praat_Command action = lookUpMatchingAction (class1, class2, class3, nullptr, title);
+		if (! action) {
 			Melder_throw (U"Action command \"", class1 ? class1 -> className : nullptr,
 				class2 ? U" & ": nullptr, class2 ? class2 -> className : nullptr,
 				class3 ? U" & ": nullptr, class3 ? class3 -> className : nullptr,
 				U": ", title, U"\" not found."
 			);
 		}
-		Praat_Command action = theActions.at [found];
 		if (action -> hidden) {
 			action -> hidden = false;
 			if (praatP.phase >= praat_READING_BUTTONS)
@@ -845,12 +897,11 @@ void praat_saveToggledActions (MelderString *buffer) {
 
 int praat_doAction (conststring32 title, conststring32 arguments, Interpreter interpreter) {
 	Praat_Command actionFound = nullptr;
-	for (integer i = 1; i <= theActions.size; i ++) {
-		Praat_Command action = theActions.at [i];
-		if (action -> executable && str32equ (action -> title.get(), title)) {
+	const auto range = theActionsByTitle. equal_range (title);
+	for (auto it = range.first; it != range.second; ++ it) {
+		Praat_Command action = it -> second;
+		if (action -> executable && (! actionFound || actionComesBefore (action, actionFound)))
 			actionFound = action;
-			break;
-		}
 	}
 	if (! actionFound)
 		return 0;
@@ -875,12 +926,11 @@ int praat_doAction (conststring32 title, conststring32 arguments, Interpreter in
 
 int praat_doAction (conststring32 title, integer narg, Stackel args, Interpreter interpreter) {
 	Praat_Command actionFound = nullptr;
-	for (integer i = 1; i <= theActions.size; i ++) {
-		Praat_Command action = theActions.at [i];
-		if (action -> executable && str32equ (action -> title.get(), title)) {
+	const auto range = theActionsByTitle. equal_range (title);
+	for (auto it = range.first; it != range.second; ++ it) {
+		Praat_Command action = it -> second;
+		if (action -> executable && (! actionFound || actionComesBefore (action, actionFound)))
 			actionFound = action;
-			break;
-		}
 	}
 	if (! actionFound)
 		return 0;
@@ -1,6 +1,6 @@
 /* praat_menuCommands.cpp
  *
- * Copyright (C) 1992-2018,2020-2025 Paul Boersma
+ * Copyright (C) 1992-2018,2020-2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,10 +19,38 @@
 #include "praatP.h"
 #include "praat_script.h"
 #include "GuiP.h"
+#include <unordered_map>
 
 static OrderedOf <structPraat_Command> theCommands;
 void praat_menuCommands_exit_optimizeByLeaking () { theCommands. _ownItems = false; }
 
+/*
+	Scripts and the registration of commands look up menu commands by title,
+	so we keep an index from each title to all the menu commands with that title.
+	Menu commands are never removed, so the index only has to be updated when a command is added.
+*/
+static std::unordered_multimap <std::u32string, Praat_Command> theCommandsByTitle;
+
+static void addCommand (autoPraat_Command command, integer position) {
+	if (command -> title)
+		theCommandsByTitle. emplace (command -> title.get(), command.get());
+	theCommands. addItemAtPosition_move (command.move(), position);
+}
+static integer positionOfCommand (Praat_Command command) {
+	for (integer i = theCommands.size; i > 0; i --)
+		if (theCommands.at [i] == command)
+			return i;
+	Melder_assert (false);
+	return 0;
+}
+static bool commandComesBefore (Praat_Command me, Praat_Command thee) {
+	/*
+		Only needed if several commands with the same title compete,
+		in which case the first one in the list wins, as it would in a linear search.
+	*/
+	return positionOfCommand (me) < positionOfCommand (thee);
+}
+
 void praat_sortMenuCommands () {
 	for (integer i = 1; i <= theCommands.size; i ++) {
 		Praat_Command command = theCommands.at [i];
@@ -51,23 +79,25 @@ void praat_sortMenuCommands () {
 	);
 }
 
-static integer lookUpMatchingMenuCommand_0 (conststring32 window, conststring32 menu, conststring32 title) {
+static Praat_Command lookUpMatchingMenuCommand_0 (conststring32 window, conststring32 menu, conststring32 title) {
 	/*
 		A menu command is fully specified by its environment (window + menu) and its title.
 	*/
-	for (integer i = 1; i <= theCommands.size; i ++) {
-		Praat_Command command = theCommands.at [i];
+	Melder_assert (title);
+	Praat_Command commandFound = nullptr;
+	const auto range = theCommandsByTitle. equal_range (title);
+	for (auto it = range.first; it != range.second; ++ it) {
+		Praat_Command command = it -> second;
 		conststring32 tryWindow = command -> window.get();
 		conststring32 tryMenu = command -> menu.get();
-		conststring32 tryTitle = command -> title.get();
 		if (
 			(window == tryWindow || (window && tryWindow && str32equ (window, tryWindow))) &&
 			(menu == tryMenu || (menu && tryMenu && str32equ (menu, tryMenu))) &&
-			(title == tryTitle || (title && tryTitle && str32equ (title, tryTitle)))
+			(! commandFound || commandComesBefore (command, commandFound))
 		)
-			return i;
+			commandFound = command;
 	}
-	return 0;   // not found
+	return commandFound;   // null if not found
 }
 
 static void do_menu (Praat_Command me, bool isModified) {
@@ -136,14 +166,14 @@ static GuiMenuItem praat_addMenuCommand__ (conststring32 window, conststring32 m
 	*/
 	integer position;
 	if (after) {   // search for existing command with same selection
-		const integer found = lookUpMatchingMenuCommand_0 (window, menu, after);
-		if (found == 0) {
+		const Praat_Command found = lookUpMatchingMenuCommand_0 (window, menu, after);
+		if (! found) {
 			Melder_flushError (U"praat_addMenuCommand: the command \"", title, U"\" cannot be put after \"", after, U"\",\n"
 				U"in the menu \"", menu, U"\" in the window \"", window, U"\"\n"
 				U"because the latter command does not exist.");
 			return nullptr;
 		}
-		position = found + 1;   // after 'after'
+		position = positionOfCommand (found) + 1;   // after 'after'
 	} else {
 		position = theCommands.size + 1;   // at end
 	}
@@ -229,7 +259,7 @@ static GuiMenuItem praat_addMenuCommand__ (conststring32 window, conststring32 m
 			GuiThing_hide (command -> button);
 	}
 	Thing_cast (GuiMenuItem, button_as_GuiMenuItem, command -> button);
-	theCommands. addItemAtPosition_move (command.move(), position);
+	addCommand (command.move(), position);
 	return button_as_GuiMenuItem;
 }
 GuiMenuItem praat_addMenuCommand_ (conststring32 window, conststring32 menu, conststring32 title /* cattable */,
@@ -273,14 +303,14 @@ void praat_addMenuCommandScript (conststring32 window, conststring32 menu, const
 		*/
 		integer position;
 		if (Melder_length (after)) {   // search for existing command with same selection
-			const integer found = lookUpMatchingMenuCommand_0 (window, menu, after);
-			if (found == 0) {
+			const Praat_Command found = lookUpMatchingMenuCommand_0 (window, menu, after);
+			if (! found) {
 				/*Melder_throw (U"The menu command \"", title, U"\" cannot be put after \"", after, U"\",\n"
 					U"in the menu \"", menu, "\" in the window \"", window, U"\"\n"
 					U"because the latter command does not exist.");*/
 				position = theCommands.size + 1;   // default: at end
 			} else
-				position = found + 1;   // after 'after'
+				position = positionOfCommand (found) + 1;   // after 'after'
 		} else {
 			position = theCommands.size + 1;   // at end
 		}
@@ -349,7 +379,7 @@ void praat_addMenuCommandScript (conststring32 window, conststring32 menu, const
 				}
 			}
 		}
-		theCommands. addItemAtPosition_move (command.move(), position);
+		addCommand (command.move(), position);
 
 		if (praatP.phase >= praat_HANDLING_EVENTS)
 			praat_sortMenuCommands ();
@@ -361,10 +391,9 @@ void praat_addMenuCommandScript (conststring32 window, conststring32 menu, const
 void praat_hideMenuCommand (conststring32 window, conststring32 menu, conststring32 title) {
 	if (theCurrentPraatApplication -> batch || ! window || ! menu || ! title)
 		return;
-	const integer found = lookUpMatchingMenuCommand_0 (window, menu, title);
-	if (found == 0)
+	const Praat_Command command = lookUpMatchingMenuCommand_0 (window, menu, title);
+	if (! command)
 		return;
-	Praat_Command command = theCommands.at [found];
 	if (! command -> hidden && ! command -> unhidable) {
 		command -> hidden = true;
 		if (praatP.phase >= praat_READING_BUTTONS)
@@ -377,10 +406,9 @@ void praat_hideMenuCommand (conststring32 window, conststring32 menu, conststrin
 void praat_showMenuCommand (conststring32 window, conststring32 menu, conststring32 title) {
 	if (theCurrentPraatApplication -> batch || ! window || ! menu || ! title)
 		return;
-	const integer found = lookUpMatchingMenuCommand_0 (window, menu, title);
-	if (found == 0)
+	const Praat_Command command = lookUpMatchingMenuCommand_0 (window, menu, title);
+	if (! command)
 		return;
-	Praat_Command command = theCommands.at [found];
 	if (command -> hidden) {
 		command -> hidden = false;
 		if (praatP.phase >= praat_READING_BUTTONS)
@@ -441,7 +469,7 @@ void praat_addFixedButtonCommand_ (GuiForm parent, conststring32 title, UiCallba
 		GuiThing_show (button);
 	}
 	my executable = false;
-	theCommands. addItemAtPosition_move (me.move(), 0);
+	addCommand (me.move(), 0);
 }
 
 void praat_sensitivizeFixedButtonCommand (conststring32 title, bool sensitive) {
@@ -462,14 +490,14 @@ void praat_sensitivizeFixedButtonCommand (conststring32 title, bool sensitive) {
 
 int praat_doMenuCommand (conststring32 title, conststring32 arguments, Interpreter interpreter) {
 	Praat_Command commandFound = nullptr;
-	for (integer i = 1; i <= theCommands.size; i ++) {
-		Praat_Command command = theCommands.at [i];
-		if (command -> executable && str32equ (command -> title.get(), title) &&
-			(str32equ (command -> window.get(), U"Objects") || str32equ (command -> window.get(), U"Picture")))
-		{
+	const auto range = theCommandsByTitle. equal_range (title);
+	for (auto it = range.first; it != range.second; ++ it) {
+		Praat_Command command = it -> second;
+		if (command -> executable &&
+			(str32equ (command -> window.get(), U"Objects") || str32equ (command -> window.get(), U"Picture")) &&
+			(! commandFound || commandComesBefore (command, commandFound))
+		)
 			commandFound = command;
-			break;
-		}
 	}
 	if (! commandFound)
 		return 0;
@@ -494,14 +522,14 @@ int praat_doMenuCommand (conststring32 title, conststring32 arguments, Interpret
 
 int praat_doMenuCommand (conststring32 title, integer narg, Stackel args, Interpreter interpreter) {
 	Praat_Command commandFound = nullptr;
-	for (integer i = 1; i <= theCommands.size; i ++) {
-		Praat_Command command = theCommands.at [i];
-		if (command -> executable && str32equ (command -> title.get(), title) &&
-			(str32equ (command -> window.get(), U"Objects") || str32equ (command -> window.get(), U"Picture")))
-		{
+	const auto range = theCommandsByTitle. equal_range (title);
+	for (auto it = range.first; it != range.second; ++ it) {
+		Praat_Command command = it -> second;
+		if (command -> executable &&
+			(str32equ (command -> window.get(), U"Objects") || str32equ (command -> window.get(), U"Picture")) &&
+			(! commandFound || commandComesBefore (command, commandFound))
+		)
 			commandFound = command;
-			break;
-		}
 	}
 	if (! commandFound)
 		return 0;
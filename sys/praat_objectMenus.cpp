@@ -616,6 +616,19 @@ FORM_SAVE (SAVE_Data_writeToBinaryFile, U"Save Object(s) as one binary file", nu
 	END_NO_NEW_DATA
 }
 
+FORM_SAVE (SAVE_Data_writeToMappableBinaryFile, U"Save Object(s) as one mappable binary file", nullptr, nullptr) {
+	if (theCurrentPraatObjects -> totalSelection == 1) {
+		LOOP {
+			iam_LOOP (Daata);
+			Data_writeToMappableBinaryFile (me, file);
+		}
+	} else {
+		autoCollection set = praat_getSelectedObjects ();
+		Data_writeToMappableBinaryFile (set.get(), file);
+	}
+	END_NO_NEW_DATA
+}
+
 FORM (PRAAT_ManPages_saveToHtmlFolder, U"Save all pages as HTML files", nullptr) {
 	FOLDER (folder, U"Folder", U"")
 OK
@@ -930,6 +943,8 @@ void praat_addMenus (GuiWindow window) {
 			nullptr, 0, SAVE_Data_writeToShortTextFile);   // alternative GuiMenu_DEPRECATED_2011
 	praat_addAction1 (classDaata, 0, U"Save as binary file... || Write to binary file...",
 			nullptr, 0, SAVE_Data_writeToBinaryFile);   // alternative GuiMenu_DEPRECATED_2011
+	praat_addAction1 (classDaata, 0, U"Save as mappable binary file...",
+			nullptr, 0, SAVE_Data_writeToMappableBinaryFile);
 
 	praat_addAction1 (classManPages, 1, U"Save to HTML folder... || Save to HTML directory...",
 			nullptr, 0, PRAAT_ManPages_saveToHtmlFolder);   // alternative GuiMenu_DEPRECATED_2020